@@ -0,0 +1,815 @@
+#include "util/common.h"
+#include "util/map.h"
+#include "util/intern.h"
+
+#include "parser/parser.h"
+#include "parser/tokenizer.h"
+
+#include "game/level.h"
+#include "game/tiled.h"
+#include "game/tilepicker.h"
+
+#include <time.h>
+
+
+// Defines
+#define BENCH_CONFIG_PATH           "/tmp/ctiled_bench_config.yaml"
+#define BENCH_LEVEL_PATH            "/tmp/ctiled_bench_level"
+
+#define BENCH_DEFAULT_WARMUP        1
+#define BENCH_DEFAULT_REPETITIONS   5
+#define BENCH_MAX_REPETITIONS       100
+
+#define BENCH_IO_MAX_SIZE           4096 // Saving and loading a 16384 level moves gigabytes per format
+#define BENCH_TILE_SIZE             32
+#define BENCH_VIEW_WIDTH            1920
+#define BENCH_VIEW_HEIGHT           1080
+#define BENCH_TILESET_TILES         64
+#define BENCH_QUAD_BATCH            4096 // Quads per batch, flushed by wrapping around
+#define BENCH_PICKER_QUERIES        10000
+
+// Options
+typedef struct BenchOptions {
+    uint32_t warmup;
+    uint32_t repetitions;
+    uint32_t max_size;
+    const char* filter;
+    const char* json_path;
+} BenchOptions;
+
+// Result of one benchmark, times in seconds
+typedef struct BenchResult {
+    char name[48];
+    uint32_t param;
+    uint64_t items; // Work done per repetition
+
+    uint32_t count;
+    double mean;
+    double stddev;
+    double min;
+    double median;
+    double max;
+    double ci_low; // 95% confidence interval of the mean
+    double ci_high;
+} BenchResult;
+VECTOR_DECLARE(BenchResult, 0);
+
+typedef uint64_t (*bench_func_t)(void* user); // Returns the items processed
+
+static BenchOptions options_;
+static VECTOR(BenchResult) results_;
+
+// Two sided 97.5% quantiles of Student's t for 1 to 30 degrees of freedom
+static const double t_quantiles_[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+};
+
+// Static
+static double bench_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static int bench_compare(const void* a, const void* b) {
+    double lhs = *(const double*) a;
+    double rhs = *(const double*) b;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static void bench_summarize(BenchResult* result, double* samples, uint32_t count) {
+
+    qsort(samples, count, sizeof(double), bench_compare);
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum += samples[i];
+    }
+
+    double mean = sum / count;
+
+    double variance = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        variance += (samples[i] - mean) * (samples[i] - mean);
+    }
+    variance = (count > 1) ? variance / (count - 1) : 0.0;
+
+    double t = (count < 2) ? 0.0 : (count - 1 <= 30) ? t_quantiles_[count - 2] : 1.96;
+    double margin = t * sqrt(variance / count);
+
+    result->count = count;
+    result->mean = mean;
+    result->stddev = sqrt(variance);
+    result->min = samples[0];
+    result->max = samples[count - 1];
+    result->median = (count % 2) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) * 0.5;
+    result->ci_low = mean - margin;
+    result->ci_high = mean + margin;
+}
+
+static void bench_run(const char* name, uint32_t param, bench_func_t func, void* user) {
+
+    if (options_.filter && !strstr(name, options_.filter)) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < options_.warmup; ++i) {
+        func(user);
+    }
+
+    double samples[BENCH_MAX_REPETITIONS];
+    uint64_t items = 0;
+
+    for (uint32_t i = 0; i < options_.repetitions; ++i) {
+        double start = bench_time();
+        items = func(user);
+        samples[i] = bench_time() - start;
+    }
+
+    BenchResult result = (BenchResult) {
+        .param = param,
+        .items = items,
+    };
+    snprintf(result.name, sizeof(result.name), "%s", name);
+
+    bench_summarize(&result, samples, options_.repetitions);
+
+    VECTOR_PUSH(&results_, result);
+
+    printf(
+        "%-24s %10u %12.3f %12.3f %12.3f %12.3f %12.2f\n",
+        name, param, result.mean * 1e3, (result.ci_high - result.ci_low) * 0.5e3,
+        result.median * 1e3, result.min * 1e3, (items) ? result.median / items * 1e9 : 0.0
+    );
+}
+
+static bool bench_write_json(const char* path) {
+
+    FILE* file;
+    if (!(file = fopen(path, "wb"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        return false;
+    }
+
+    fprintf(file, "{\"version\":1,\"warmup\":%u,\"repetitions\":%u,\"unit\":\"ms\",\"results\":[", options_.warmup, options_.repetitions);
+
+    for (uint32_t i = 0; i < results_.count; ++i) {
+        const BenchResult* result = &VECTOR_GET(&results_, i);
+
+        fprintf(
+            file,
+            "%s\n{\"name\":\"%s\",\"param\":%u,\"items\":%" PRIu64 ",\"samples\":%u,"
+            "\"mean\":%.6f,\"stddev\":%.6f,\"min\":%.6f,\"median\":%.6f,\"max\":%.6f,"
+            "\"ci95\":[%.6f,%.6f],\"ns_per_item\":%.3f}",
+            (i) ? "," : "", result->name, result->param, result->items, result->count,
+            result->mean * 1e3, result->stddev * 1e3, result->min * 1e3, result->median * 1e3, result->max * 1e3,
+            result->ci_low * 1e3, result->ci_high * 1e3, (result->items) ? result->median / result->items * 1e9 : 0.0
+        );
+    }
+
+    fprintf(file, "\n]}\n");
+
+    if (fclose(file) != 0) {
+        printf("ERROR: Failed to write '%s'.\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+// Config shaped like the real one, sections with indented keys and trailing comments
+static char* bench_generate_config(uint32_t entries, size_t* len) {
+
+    size_t capacity = (size_t) entries * 64 + 64;
+    char* buffer = (char*) malloc(capacity);
+    size_t used = 0;
+
+    for (uint32_t i = 0; i < entries; ++i) {
+        if (i % 16 == 0) {
+            used += sprintf(buffer + used, "section-%u:\n", i / 16);
+        }
+        used += sprintf(buffer + used, "    key-%u: %u # comment\n", i, i * 7);
+    }
+
+    *len = used;
+    return buffer;
+}
+
+// Parser
+typedef struct BenchConfig {
+    const char* buffer;
+    size_t len;
+    uint32_t entries;
+
+    ParserDocument* document;
+} BenchConfig;
+
+static uint64_t bench_tokenize(void* user) {
+    BenchConfig* config = (BenchConfig*) user;
+
+    ParserTokenizer tokenizer;
+    parser_tokenizer_init(&tokenizer, config->buffer, config->len);
+
+    ParserToken token;
+    uint64_t count = 0;
+    while (parser_tokenizer_next(&tokenizer, &token) == PARSER_TOKEN_OK) {
+        count++;
+    }
+
+    return count;
+}
+
+static uint64_t bench_parse(void* user) {
+    BenchConfig* config = (BenchConfig*) user;
+
+    ParserDocument* document = parser_parse_yaml(BENCH_CONFIG_PATH);
+    if (!document) {
+        return 0;
+    }
+
+    parser_document_free(document);
+
+    return config->entries;
+}
+
+static uint64_t bench_lookup(void* user) {
+    BenchConfig* config = (BenchConfig*) user;
+
+    // Resolve every key through its section
+    char path[64];
+    uint64_t found = 0;
+
+    for (uint32_t i = 0; i < config->entries; ++i) {
+        sprintf(path, "section-%u.key-%u", i / 16, i);
+        found += parser_document_get(config->document, path) != NULL;
+    }
+
+    if (found != config->entries) {
+        printf("ERROR: Found '%" PRIu64 "' of '%u' keys.\n", found, config->entries);
+    }
+
+    return config->entries;
+}
+
+static void bench_parser() {
+
+    const uint32_t sizes[] = { 1000, 10000, 100000, 1000000 };
+
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+
+        BenchConfig config = (BenchConfig) {
+            .entries = sizes[i],
+        };
+
+        char* buffer = bench_generate_config(sizes[i], &config.len);
+        config.buffer = buffer;
+
+        bench_run("tokenize", sizes[i], bench_tokenize, &config);
+
+        FILE* file;
+        if (!(file = fopen(BENCH_CONFIG_PATH, "wb"))) {
+            printf("ERROR: File '%s' could not be opened.\n", BENCH_CONFIG_PATH);
+            free(buffer);
+            continue;
+        }
+        fwrite(buffer, 1, config.len, file);
+        fclose(file);
+
+        bench_run("parse_yaml", sizes[i], bench_parse, &config);
+
+        if ((config.document = parser_parse_yaml(BENCH_CONFIG_PATH))) {
+            bench_run("parse_lookup", sizes[i], bench_lookup, &config);
+            parser_document_free(config.document);
+        }
+
+        remove(BENCH_CONFIG_PATH);
+        free(buffer);
+    }
+}
+
+// Map, intern pool & vector
+typedef struct BenchKeys {
+    char* keys; // Fixed width, null terminated
+    uint64_t* hashes; // Precomputed, the way a property table would keep them
+    uint32_t count;
+    Map map;
+} BenchKeys;
+
+#define BENCH_KEY_SIZE 16
+
+static uint64_t bench_map_set(void* user) {
+    BenchKeys* keys = (BenchKeys*) user;
+
+    Map map = map_new();
+    for (uint32_t i = 0; i < keys->count; ++i) {
+        const char* key = keys->keys + (size_t) i * BENCH_KEY_SIZE;
+        uint32_t key_len = strlen(key);
+        map_set_key_hashed(&map, key, key_len, keys->hashes[i], key, key_len);
+    }
+    map_free(&map);
+
+    return keys->count;
+}
+
+static uint64_t bench_map_get(void* user) {
+    BenchKeys* keys = (BenchKeys*) user;
+
+    uint64_t found = 0;
+    for (uint32_t i = 0; i < keys->count; ++i) {
+        const char* key = keys->keys + (size_t) i * BENCH_KEY_SIZE;
+        found += map_get_key_hashed(&keys->map, key, strlen(key), keys->hashes[i]) != NULL;
+    }
+
+    if (found != keys->count) {
+        printf("ERROR: Found '%" PRIu64 "' of '%u' map keys.\n", found, keys->count);
+    }
+
+    return keys->count;
+}
+
+static uint64_t bench_intern_insert(void* user) {
+    BenchKeys* keys = (BenchKeys*) user;
+
+    // Starts from an empty pool every run, the parser benchmarks don't keep anything interned
+    intern_free();
+    for (uint32_t i = 0; i < keys->count; ++i) {
+        const char* key = keys->keys + (size_t) i * BENCH_KEY_SIZE;
+        intern_string(key, strlen(key));
+    }
+
+    return keys->count;
+}
+
+static uint64_t bench_intern_lookup(void* user) {
+    BenchKeys* keys = (BenchKeys*) user;
+
+    // Every key is already interned, each call is a lookup
+    uint64_t found = 0;
+    for (uint32_t i = 0; i < keys->count; ++i) {
+        const char* key = keys->keys + (size_t) i * BENCH_KEY_SIZE;
+        found += intern_string(key, strlen(key)) != key;
+    }
+
+    if (found != keys->count) {
+        printf("ERROR: Found '%" PRIu64 "' of '%u' interned keys.\n", found, keys->count);
+    }
+
+    return keys->count;
+}
+
+typedef int32_t BenchValue;
+VECTOR_DECLARE(BenchValue, 0);
+
+static uint64_t bench_vector_push(void* user) {
+    uint32_t count = *(uint32_t*) user;
+
+    VECTOR(BenchValue) vector;
+    VECTOR_INIT(&vector, NULL);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        VECTOR_PUSH(&vector, (BenchValue) i);
+    }
+
+    VECTOR_FREE(&vector);
+
+    return count;
+}
+
+static uint64_t bench_vector_push_reserved(void* user) {
+    uint32_t count = *(uint32_t*) user;
+
+    VECTOR(BenchValue) vector;
+    VECTOR_INIT(&vector, NULL);
+    VECTOR_RESERVE(&vector, count);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        VECTOR_PUSH(&vector, (BenchValue) i);
+    }
+
+    VECTOR_FREE(&vector);
+
+    return count;
+}
+
+static void bench_containers() {
+
+    const uint32_t sizes[] = { 1000, 100000, 1000000 };
+
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+
+        BenchKeys keys = (BenchKeys) {
+            .keys = (char*) malloc((size_t) sizes[i] * BENCH_KEY_SIZE),
+            .hashes = (uint64_t*) malloc(sizeof(uint64_t) * sizes[i]),
+            .count = sizes[i],
+            .map = map_new(),
+        };
+
+        for (uint32_t k = 0; k < keys.count; ++k) {
+            char* key = keys.keys + (size_t) k * BENCH_KEY_SIZE;
+            snprintf(key, BENCH_KEY_SIZE, "key-%u", k);
+
+            uint32_t key_len = strlen(key);
+            keys.hashes[k] = map_hash(key, key_len);
+            map_set_key_hashed(&keys.map, key, key_len, keys.hashes[k], key, key_len);
+        }
+
+        bench_run("map_set", sizes[i], bench_map_set, &keys);
+        bench_run("map_get", sizes[i], bench_map_get, &keys);
+
+        // Map keys live in the intern pool, which the intern benchmarks reset
+        map_free(&keys.map);
+
+        bench_run("intern_insert", sizes[i], bench_intern_insert, &keys);
+
+        // A filtered run may have skipped the inserts
+        bench_intern_insert(&keys);
+        bench_run("intern_lookup", sizes[i], bench_intern_lookup, &keys);
+
+        intern_free();
+        free(keys.hashes);
+        free(keys.keys);
+
+        uint32_t count = sizes[i];
+        bench_run("vector_push", sizes[i], bench_vector_push, &count);
+        bench_run("vector_push_reserved", sizes[i], bench_vector_push_reserved, &count);
+    }
+}
+
+// Level
+typedef struct BenchQuad {
+    float position[4][2];
+    float uv[4][2];
+} BenchQuad;
+
+typedef struct BenchLevel {
+    Level* level;
+    LevelBounds view;
+    int32_t tile;
+    const char* path;
+    int32_t format;
+    int32_t compression;
+
+    // Quad generation, mirrors render_tiles without the GL calls
+    vec4s sources[BENCH_TILESET_TILES];
+    BenchQuad* quads;
+    uint32_t quad_index;
+    uint64_t quad_count;
+} BenchLevel;
+
+// Deterministic half painted level with clustered tiles, closer to a real map than noise
+static void bench_paint_level(Level* level) {
+
+    uint32_t state = 0x12345678;
+    size_t cells = (size_t) level->size * level->size;
+
+    for (size_t i = 0; i < cells; ++i) {
+        state = state * 1664525u + 1013904223u;
+        level->data[i] = ((state >> 16) & 1) ? (int32_t) ((i / 7) % BENCH_TILESET_TILES) : LEVEL_EMPTY_TILE;
+    }
+
+    game_level_recalculate_stats(level);
+}
+
+static void bench_emit_quad(int32_t x, int32_t y, int32_t tile, void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    BenchQuad* quad = &bench->quads[bench->quad_index];
+    bench->quad_index = (bench->quad_index + 1) % BENCH_QUAD_BATCH;
+    bench->quad_count++;
+
+    float left = (float) x * BENCH_TILE_SIZE;
+    float bottom = (float) y * BENCH_TILE_SIZE;
+    vec4s source = bench->sources[(tile >= 0 && tile < BENCH_TILESET_TILES) ? tile : 0];
+
+    for (uint32_t v = 0; v < 4; ++v) {
+        float right = (float) (v == 1 || v == 2);
+        float top = (float) (v >= 2);
+
+        quad->position[v][0] = left + right * BENCH_TILE_SIZE;
+        quad->position[v][1] = bottom + top * BENCH_TILE_SIZE;
+        quad->uv[v][0] = source.x + right * source.z;
+        quad->uv[v][1] = source.y + top * source.w;
+    }
+}
+
+static uint64_t bench_level_quads(void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    bench->quad_count = 0;
+    game_level_visit(bench->level, bench->view, bench_emit_quad, bench);
+
+    return bench->quad_count;
+}
+
+static uint64_t bench_level_recalculate(void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    game_level_recalculate_stats(bench->level);
+
+    return (uint64_t) bench->level->size * bench->level->size;
+}
+
+static uint64_t bench_level_save(void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    if (bench->format == TILED_FORMAT_NONE) {
+        size_t written;
+        game_level_write_raw(bench->level, bench->path, &written);
+    } else {
+        TiledTileset tileset = (TiledTileset) {
+            .image = "tileset.png",
+            .image_width = 8 * BENCH_TILE_SIZE,
+            .image_height = 8 * BENCH_TILE_SIZE,
+
+            .tile_width = BENCH_TILE_SIZE,
+            .tile_height = BENCH_TILE_SIZE,
+        };
+        game_tiled_export(bench->level, bench->path, bench->format, bench->compression, &tileset);
+    }
+
+    return (uint64_t) bench->level->size * bench->level->size;
+}
+
+static uint64_t bench_level_load(void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    if (bench->format == TILED_FORMAT_NONE) {
+        size_t read;
+        game_level_read_raw(bench->level, bench->path, &read);
+    } else {
+        game_tiled_import(bench->level, bench->path, bench->format);
+    }
+
+    return (uint64_t) bench->level->size * bench->level->size;
+}
+
+static uint64_t bench_level_fill(void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    game_level_fill(bench->level, bench->tile);
+    bench->tile = (bench->tile + 1) % BENCH_TILESET_TILES;
+
+    return (uint64_t) bench->level->size * bench->level->size;
+}
+
+static uint64_t bench_level_replace(void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    // Swap one tile id back and forth. How many cells change varies, but every repetition scans the whole level
+    int32_t from = bench->tile;
+    int32_t to = (bench->tile == 1) ? 2 : 1;
+
+    uint64_t expected = game_level_tile_count(bench->level, from);
+    uint64_t replaced = game_level_replace(bench->level, from, to);
+    bench->tile = to;
+
+    if (replaced != expected || game_level_tile_count(bench->level, from) != 0) {
+        printf("ERROR: Replaced '%" PRIu64 "' of '%" PRIu64 "' cells.\n", replaced, expected);
+    }
+
+    return (uint64_t) bench->level->size * bench->level->size;
+}
+
+static uint64_t bench_level_clear(void* user) {
+    BenchLevel* bench = (BenchLevel*) user;
+
+    game_level_clear(bench->level);
+
+    return (uint64_t) bench->level->size * bench->level->size;
+}
+
+static void bench_level_io(BenchLevel* bench, const char* name, const char* extension, int32_t format, int32_t compression) {
+
+    char path[256];
+    snprintf(path, sizeof(path), "%s%s", BENCH_LEVEL_PATH, extension);
+
+    bench->path = path;
+    bench->format = format;
+    bench->compression = compression;
+
+    char bench_name[48];
+    snprintf(bench_name, sizeof(bench_name), "save_%s", name);
+    bench_run(bench_name, bench->level->size, bench_level_save, bench);
+
+    // Loading needs the file even if saving was filtered out
+    FILE* file;
+    if ((file = fopen(path, "rb"))) {
+        fclose(file);
+    } else {
+        bench_level_save(bench);
+    }
+
+    snprintf(bench_name, sizeof(bench_name), "load_%s", name);
+    bench_run(bench_name, bench->level->size, bench_level_load, bench);
+
+    remove(path);
+}
+
+static void bench_levels() {
+
+    const uint32_t sizes[] = { 512, 4096, 16384 };
+
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+
+        uint32_t size = sizes[i];
+        if (size > options_.max_size) {
+            continue;
+        }
+
+        Level* level = game_level_new(size);
+        if (!level) {
+            continue;
+        }
+
+        BenchLevel bench = (BenchLevel) {
+            .level = level,
+            .quads = (BenchQuad*) malloc(sizeof(BenchQuad) * BENCH_QUAD_BATCH),
+        };
+
+        for (uint32_t t = 0; t < BENCH_TILESET_TILES; ++t) {
+            bench.sources[t] = (vec4s) { (t % 8) / 8.0f, (t / 8) / 8.0f, 1 / 8.0f, 1 / 8.0f };
+        }
+
+        bench_paint_level(level);
+
+        // One screen at the center, then the whole level zoomed out
+        int32_t center = size / 2;
+        int32_t half_width = BENCH_VIEW_WIDTH / BENCH_TILE_SIZE / 2;
+        int32_t half_height = BENCH_VIEW_HEIGHT / BENCH_TILE_SIZE / 2;
+
+        bench.view = (LevelBounds) { center - half_width, center - half_height, center + half_width, center + half_height };
+        bench_run("quads_view", size, bench_level_quads, &bench);
+
+        bench.view = (LevelBounds) { 0, 0, size - 1, size - 1 };
+        bench_run("quads_full", size, bench_level_quads, &bench);
+
+        bench_run("level_recalculate", size, bench_level_recalculate, &bench);
+
+        if (size <= BENCH_IO_MAX_SIZE) {
+            bench_level_io(&bench, "raw", ".bin", TILED_FORMAT_NONE, TILED_COMPRESSION_NONE);
+            bench_level_io(&bench, "csv", ".csv", TILED_FORMAT_CSV, TILED_COMPRESSION_NONE);
+            bench_level_io(&bench, "tmx", ".tmx", TILED_FORMAT_TMX, TILED_COMPRESSION_NONE);
+            bench_level_io(&bench, "tmx_zlib", ".tmx", TILED_FORMAT_TMX, TILED_COMPRESSION_ZLIB);
+            bench_level_io(&bench, "tmj_gzip", ".tmj", TILED_FORMAT_JSON, TILED_COMPRESSION_GZIP);
+        }
+
+        bench.tile = 1;
+        bench_run("level_replace", size, bench_level_replace, &bench);
+
+        bench.tile = 0;
+        bench_run("level_fill", size, bench_level_fill, &bench);
+
+        bench_run("level_clear", size, bench_level_clear, &bench);
+
+        free(bench.quads);
+        game_level_free(level);
+    }
+}
+
+// Tilepicker
+typedef struct BenchPicker {
+    VECTOR(Tile) tiles;
+    float height;
+    uint64_t hits; // Keeps the queries from being optimized out
+} BenchPicker;
+
+static uint64_t bench_picker_hit(void* user) {
+    BenchPicker* picker = (BenchPicker*) user;
+
+    // Sweep the cursor over the whole picker
+    uint64_t hits = 0;
+    for (uint32_t i = 0; i < BENCH_PICKER_QUERIES; ++i) {
+        double cursor[2] = { (i % 97) * 3.0, fmod(i * 7.31, picker->height) };
+        hits += game_tilepicker_hit(&picker->tiles, 0.0f, cursor) >= 0;
+    }
+
+    picker->hits = hits;
+
+    return BENCH_PICKER_QUERIES;
+}
+
+static void bench_tilepicker() {
+
+    const uint32_t counts[] = { 64, 1024, 16384 };
+
+    for (uint32_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+
+        // Same three column layout as the menu's picker
+        const float render_size = 300.0f / 3.0f;
+
+        BenchPicker picker;
+        VECTOR_INIT(&picker.tiles, NULL);
+        VECTOR_RESERVE(&picker.tiles, counts[i]);
+
+        picker.height = ((counts[i] / 3) * render_size) + render_size;
+
+        for (uint32_t t = 0; t < counts[i]; ++t) {
+            Tile tile = (Tile) {
+                .pos = (vec2s) { (t % 3) * render_size, picker.height - ((t / 3) * render_size) - render_size },
+                .size = render_size,
+                .index = t,
+            };
+            VECTOR_PUSH(&picker.tiles, tile);
+        }
+
+        bench_run("tilepicker_hit", counts[i], bench_picker_hit, &picker);
+
+        VECTOR_FREE(&picker.tiles);
+    }
+}
+
+static void bench_usage() {
+    printf("Usage: ctiled_bench [--json <path>] [--warmup <n>] [--repetitions <n>] [--max-size <n>] [--filter <name>]\n");
+}
+
+static bool bench_parse_uint(const char* option, const char* text, uint32_t* value) {
+    char* end;
+    unsigned long parsed = strtoul(text, &end, 10);
+
+    if (end == text || *end != '\0' || *text == '-' || parsed > UINT32_MAX) {
+        printf("ERROR: Option '%s' expects a number, got '%s'.\n", option, text);
+        return false;
+    }
+
+    *value = (uint32_t) parsed;
+    return true;
+}
+
+int main(int argc, char** argv) {
+
+    options_ = (BenchOptions) {
+        .warmup = BENCH_DEFAULT_WARMUP,
+        .repetitions = BENCH_DEFAULT_REPETITIONS,
+        .max_size = UINT32_MAX,
+    };
+
+    for (int32_t i = 1; i < argc; ++i) {
+        const char* option = argv[i];
+
+        if (strcmp(option, "--help") == 0 || strcmp(option, "-h") == 0) {
+            bench_usage();
+            return 0;
+        }
+
+        bool known = strcmp(option, "--json") == 0 || strcmp(option, "--warmup") == 0 || 
+                     strcmp(option, "--repetitions") == 0 || strcmp(option, "--max-size") == 0 || 
+                     strcmp(option, "--filter") == 0;
+
+        if (!known) {
+            printf("ERROR: Unknown option '%s'.\n", option);
+            bench_usage();
+            return -1;
+        }
+
+        // Every other option takes a value, a run without it would silently fall back to the full suite
+        if (i + 1 >= argc) {
+            printf("ERROR: Option '%s' is missing its value.\n", option);
+            bench_usage();
+            return -1;
+        }
+        const char* value = argv[++i];
+
+        bool valid = true;
+        if (strcmp(option, "--json") == 0) {
+            options_.json_path = value;
+        } else if (strcmp(option, "--warmup") == 0) {
+            valid = bench_parse_uint(option, value, &options_.warmup);
+        } else if (strcmp(option, "--repetitions") == 0) {
+            valid = bench_parse_uint(option, value, &options_.repetitions);
+        } else if (strcmp(option, "--max-size") == 0) {
+            valid = bench_parse_uint(option, value, &options_.max_size);
+        } else if (strcmp(option, "--filter") == 0) {
+            options_.filter = value;
+        }
+
+        if (!valid) {
+            bench_usage();
+            return -1;
+        }
+    }
+
+    if (options_.repetitions < 1 || options_.repetitions > BENCH_MAX_REPETITIONS) {
+        printf("ERROR: Repetitions must be between 1 and %d.\n", BENCH_MAX_REPETITIONS);
+        return -1;
+    }
+
+    VECTOR_INIT(&results_, NULL);
+
+    printf("%-24s %10s %12s %12s %12s %12s %12s\n", "benchmark", "param", "mean(ms)", "ci95(+-ms)", "median(ms)", "min(ms)", "ns/item");
+
+    bench_parser();
+    bench_containers();
+    bench_levels();
+    bench_tilepicker();
+
+    bool written = !options_.json_path || bench_write_json(options_.json_path);
+
+    VECTOR_FREE(&results_);
+    intern_free();
+
+    return (written) ? 0 : -1;
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "capture.h"
+
+#include "window.h"
+#include "replay.h"
+
+#include "util/png.h"
+
+
+// Pending captures
+typedef struct CaptureRequest {
+    const char* path;
+    uint32_t frame;
+} CaptureRequest;
+
+static CaptureRequest requests_[CAPTURE_MAX_REQUESTS];
+static uint32_t request_count_;
+static uint32_t frame_;
+
+// Requests
+bool engine_capture_request(const char* path, uint32_t frame) {
+
+    if (request_count_ == CAPTURE_MAX_REQUESTS) {
+        printf("ERROR: Only %d frame captures can be requested.\n", CAPTURE_MAX_REQUESTS);
+        return false;
+    }
+
+    requests_[request_count_++] = (CaptureRequest) {
+        .path = path,
+        .frame = frame,
+    };
+
+    return true;
+}
+
+// Frame
+void engine_capture_frame() {
+
+    for (uint32_t i = 0; i < request_count_; ++i) {
+        if (requests_[i].frame != frame_) {
+            continue;
+        }
+
+        if (engine_capture_write(requests_[i].path)) {
+            printf("INFO: Captured frame %u to '%s'.\n", frame_, requests_[i].path);
+        }
+
+        // Done, the last request takes its place
+        requests_[i--] = requests_[--request_count_];
+
+        // A headless golden image run is over once its frames are written, unless a replay still drives it
+        if (!request_count_ && engine_window_headless() && engine_replay_mode() != REPLAY_MODE_PLAY) {
+            glfwSetWindowShouldClose(engine_glfw_window(), true);
+        }
+    }
+
+    frame_++;
+}
+
+// Write
+bool engine_capture_write(const char* path) {
+
+    vec2s size = engine_window_get_pixel_size();
+    uint32_t width = (uint32_t) size.x;
+    uint32_t height = (uint32_t) size.y;
+
+    uint8_t* pixels = (uint8_t*) malloc((size_t) width * height * 4);
+
+    // Reads the bound target, the back buffer of a window or the offscreen framebuffer when headless
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+
+    bool written = png_write(path, pixels, width, height, true);
+    free(pixels);
+
+    return written;
+}
\ No newline at end of file
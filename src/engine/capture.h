@@ -0,0 +1,16 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Defines
+#define CAPTURE_MAX_REQUESTS 16
+
+// Requests, frames count from 0 at the first presented frame, the path must outlive the capture
+bool engine_capture_request(const char* path, uint32_t frame);
+
+// Frame, called by engine_swap_buffers right before the frame is presented
+void engine_capture_frame();
+
+// Writes the frame about to be presented to a PNG
+bool engine_capture_write(const char* path);
\ No newline at end of file
@@ -1,6 +1,17 @@
 #include "engine.h"
 
 #include "input.h"
+#include "watch.h"
+#include "texture.h"
+#include "profiler.h"
+#include "renderer.h"
+#include "replay.h"
+#include "capture.h"
+#include "overlay.h"
+#include "pacing.h"
+#include "settings.h"
+#include "trace.h"
+#include "window.h"
 
 // Current dir
 static char* current_dir_; // Get the current dir from argv[0]
@@ -11,12 +22,32 @@ static const double DELTA_TIME_HIGH = 0.1;
 static double delta_time_last_;
 static double delta_time_;
 
+// Fixed timestep
+static const double TICK_DELTA = 1.0 / ENGINE_TICK_RATE;
+
+static double tick_accumulator_;
+static uint64_t tick_count_;
+
+// Frame memory
+#define FRAME_ARENA_SIZE (1024 * 1024)
+
+static Arena frame_arena_;
+
+static uint64_t frame_heap_total_;
+static uint64_t frame_heap_allocations_;
+static double frame_heap_warning_time_;
+
 // FPS
 static double crnt_time_;
 static double prev_time_;
 static uint32_t fps_counter_;
 static uint32_t fps_;
 
+// Redraw on demand
+#define IDLE_TIMEOUT 0.5 // Seconds, an idle loop still wakes up to poll for file changes
+
+static int32_t redraw_requested_; // Set by input callbacks, reloads and anything else that changes what's drawn
+
 // Performance
 void engine_calculate_delta_time() {
     double delta_time_current = glfwGetTime();
@@ -26,7 +57,13 @@ void engine_calculate_delta_time() {
         delta_time_ = DELTA_TIME_HIGH;
     }
 
+    // Recorded alongside the input, a replay runs on the recorded times instead of the clock
+    delta_time_ = engine_replay_frame(delta_time_);
+
     delta_time_last_ = delta_time_current;
+
+    // Replays feed the same deltas, so they run the same ticks. The clamp above bounds the ticks per frame
+    tick_accumulator_ += delta_time_;
 }
 
 double engine_delta_time() {
@@ -50,6 +87,85 @@ uint32_t engine_fps() {
     return fps_;
 }
 
+// Fixed timestep
+bool engine_tick() {
+    if (tick_accumulator_ < TICK_DELTA) {
+        return false;
+    }
+
+    tick_accumulator_ -= TICK_DELTA;
+    tick_count_++;
+
+    return true;
+}
+
+double engine_tick_delta() {
+    return TICK_DELTA;
+}
+
+double engine_tick_alpha() {
+    return tick_accumulator_ / TICK_DELTA;
+}
+
+uint64_t engine_tick_count() {
+    return tick_count_;
+}
+
+// Frame memory
+void engine_init_frame_arena() {
+    arena_init(&frame_arena_, FRAME_ARENA_SIZE);
+
+    // Allocate the block up front, the frames shouldn't have to
+    arena_alloc(&frame_arena_, 0);
+    arena_reset(&frame_arena_);
+
+    frame_heap_total_ = heap_get_total().allocations;
+}
+
+void engine_free_frame_arena() {
+    arena_free(&frame_arena_);
+}
+
+Arena* engine_frame_arena() {
+    return &frame_arena_;
+}
+
+void* engine_frame_alloc(size_t size) {
+    return arena_alloc(&frame_arena_, size);
+}
+
+uint64_t engine_frame_heap_allocations() {
+    return frame_heap_allocations_;
+}
+
+// Redraw on demand
+void engine_request_redraw() {
+
+    // Only the first request has to wake the main thread
+    if (!__atomic_exchange_n(&redraw_requested_, 1, __ATOMIC_ACQ_REL)) {
+        glfwPostEmptyEvent();
+    }
+}
+
+bool engine_idle_render() {
+
+    // Recordings, captures and the overlay need every frame
+    return engine_settings_get()->idle_render && 
+           !engine_window_headless() && 
+           engine_replay_mode() == REPLAY_MODE_NONE && 
+           !engine_overlay_visible() && 
+           !engine_trace_recording();
+}
+
+// Present
+void engine_swap_buffers() {
+
+    // Golden images, read while the frame is still in the back buffer, it's undefined after the swap
+    engine_capture_frame();
+
+    glfwSwapBuffers(engine_glfw_window());
+}
+
 // Events
 void engine_poll_events() {
 
@@ -62,9 +178,70 @@ void engine_poll_events() {
 
     engine_input_clear_mouse_scroll_input();
 
-    // Poll new events
-    glfwPollEvents();
+    // Wait for the next frame, still inside the one that's ending so its stats include the wait
+    // An idle editor sleeps until input arrives or something asks for a frame
+    bool redraw = __atomic_exchange_n(&redraw_requested_, 0, __ATOMIC_ACQ_REL);
+    bool idle = !redraw && engine_idle_render();
+
+    if (idle) {
+        engine_profiler_begin("idle");
+
+        // A timeout only polls the watched files, it doesn't draw unless a reload asks for it
+        do {
+            glfwWaitEventsTimeout(IDLE_TIMEOUT);
+
+            engine_watch_poll();
+            engine_texture_update();
+        } while (!__atomic_exchange_n(&redraw_requested_, 0, __ATOMIC_ACQ_REL) && 
+                 !glfwWindowShouldClose(engine_glfw_window()));
+
+        engine_profiler_end();
+
+        // The time spent waiting isn't frame time, don't let it jump the next update
+        delta_time_last_ = glfwGetTime();
+        engine_pacing_reset();
+    } else {
+
+        // Wait out the frame cap before polling, so the input is sampled as late as possible before the next frame
+        engine_profiler_begin("pacing");
+        engine_pacing_wait();
+        engine_profiler_end();
+    }
+
+    // Close the frame's timings and counters
+    engine_profiler_frame();
+    engine_renderer_frame();
+
+    // Release the last frame's memory
+    arena_reset(&frame_arena_);
+
+    // Heap calls are only counted in debug and tracking builds
+    uint64_t heap_total = heap_get_total().allocations;
+    frame_heap_allocations_ = heap_total - frame_heap_total_;
+    frame_heap_total_ = heap_total;
+
+#ifdef DEBUG
+    // A steady state frame shouldn't touch the heap, report at most once a second
+    double now = glfwGetTime();
+    if (frame_heap_allocations_ && now - frame_heap_warning_time_ >= 1.0) {
+        printf("DEBUG: %" PRIu64 " heap allocations during the last frame.\n", frame_heap_allocations_);
+        frame_heap_warning_time_ = now;
+    }
+#endif
+
+    // Poll new events, the idle wait already handled them
+    if (!idle) {
+        glfwPollEvents();
+    }
 
     // Update cursor pos
     engine_input_update_cursor_pos();
+
+    // Replayed input for this frame
+    engine_replay_apply();
+
+    // Hot reload, changed files are reloaded and swapped in before the frame
+    engine_watch_poll();
+
+    engine_texture_update();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "util/common.h"
+#include "util/arena.h"
 
 
 // Performance
@@ -12,5 +13,35 @@ void engine_calculate_fps();
 
 uint32_t engine_fps();
 
+// Fixed timestep, updates run at a constant rate however fast the frames are
+#define ENGINE_TICK_RATE 120 // Ticks per second
+
+bool engine_tick(); // Consumes one step of the frame's time, update with 'while (engine_tick())'
+
+double engine_tick_delta();
+
+double engine_tick_alpha(); // How far into the next tick the frame is, to interpolate what gets drawn
+
+uint64_t engine_tick_count();
+
+// Frame memory, released at the start of every engine_poll_events
+void engine_init_frame_arena();
+
+void engine_free_frame_arena();
+
+Arena* engine_frame_arena();
+
+void* engine_frame_alloc(size_t size);
+
+uint64_t engine_frame_heap_allocations(); // Heap calls of the last frame, debug and tracking builds only
+
+// Redraw on demand
+void engine_request_redraw(); // Safe from any thread, wakes an idle engine_poll_events
+
+bool engine_idle_render(); // Whether engine_poll_events may sleep until the next event
+
+// Present
+void engine_swap_buffers(); // Captures requested frames from the back buffer, then swaps
+
 // Events
 void engine_poll_events();
\ No newline at end of file
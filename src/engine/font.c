@@ -1,33 +1,42 @@
+#define HEAP_TAG HEAP_TAG_FONT
 #include "font.h"
 
+#include "renderer.h"
+
+#include "util/file.h"
+
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
 
 Font* engine_font_new(const char* path, uint32_t pixel_size, uint32_t filter) {
 
-    FILE* f = NULL;
-    if (!(f = fopen(path, "r"))) {
+    // The face reads from the view until it's done
+    FileView file;
+    if (!file_load(&file, path, FILE_LOAD_AUTO)) {
         printf("ERROR: File could not be opened to load font '%s'.\n", path);
         return NULL;
     }
-    fclose(f);
 
     FT_Library ft;
     if (FT_Init_FreeType(&ft)) {
         printf("ERROR: FreeType could not be initialized.\n");
+        file_release(&file);
         return NULL;
     }
 
     FT_Face face;
-    if (FT_New_Face(ft, path, 0, &face)) {
+    if (FT_New_Memory_Face(ft, (const FT_Byte*) file.data, (FT_Long) file.size, 0, &face)) {
         printf("ERROR: Failed to load font '%s'.\n", path);
+        FT_Done_FreeType(ft);
+        file_release(&file);
         return NULL;
     }
     FT_Set_Pixel_Sizes(face, 0, pixel_size); // Width calculated automatically
 
     // Allocate memory for the font
-    Font* font = (Font*) malloc(sizeof(Font));
+    // Zeroed so glyphs that fail to load have no texture
+    Font* font = (Font*) calloc(1, sizeof(Font));
 
     // Disable bytle alignment restrictions
     glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -66,6 +75,7 @@ Font* engine_font_new(const char* path, uint32_t pixel_size, uint32_t filter) {
             GL_UNSIGNED_BYTE,
             face->glyph->bitmap.buffer
         );
+        RENDER_COUNT(buffer_uploads, 1);
         
         // NOTE: Mipmap generation is removed for fonts
         //glGenerateMipmap(GL_TEXTURE_2D);
@@ -73,6 +83,9 @@ Font* engine_font_new(const char* path, uint32_t pixel_size, uint32_t filter) {
         // Unbind the texture
         glBindTexture(GL_TEXTURE_2D, 0);
 
+        // Single channel, rows are tightly packed
+        font->gpu_bytes += (int64_t) face->glyph->bitmap.width * face->glyph->bitmap.rows;
+
         // Create character
         Character chr = (Character) {
             .id = id,
@@ -89,10 +102,24 @@ Font* engine_font_new(const char* path, uint32_t pixel_size, uint32_t filter) {
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
 
+    file_release(&file);
+
+    heap_track_gpu(font->gpu_bytes);
+
     return font;
 }
 
 void engine_font_free(Font* font) {
+
+    // Glyph textures
+    for (uint32_t c = 0; c < 128; ++c) {
+        if (font->characters[c].id) {
+            glDeleteTextures(1, &font->characters[c].id);
+        }
+    }
+
+    heap_track_gpu(-font->gpu_bytes);
+
     free(font);
 }
 
@@ -107,9 +134,8 @@ vec2s engine_font_get_text_size(Font* font, const char* text, float scale) {
     for (const char* c = text; c < text + len; ++c) {
 
         // Get the character from font
-        const Character* chr = &font->characters[*c];
+        const Character* chr = &font->characters[(uint8_t) *c & 0x7F];
 
-        float width  = chr->size[0] * scale;
         float height = chr->bearing[1] * scale;
 
         float advance = chr->advance * scale;
@@ -14,6 +14,7 @@ typedef struct Character {
 // Font
 typedef struct Font {
     Character characters[128];
+    int64_t gpu_bytes; // Estimated
 } Font;
 
 // Defines
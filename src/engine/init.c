@@ -3,11 +3,39 @@
 #include "window.h"
 #include "renderer.h"
 #include "input.h"
+#include "settings.h"
+#include "watch.h"
+#include "engine.h"
+#include "profiler.h"
+#include "trace.h"
+#include "replay.h"
+#include "pacing.h"
 
+#include "util/intern.h"
+#include "util/pack.h"
+#include "util/arena.h"
+
+
+// Static
+static void engine_reload_settings(const char* path, void* user) {
+    engine_settings_load(path);
+
+    // Apply what can change at runtime, scenes pick up the rest through the settings version
+    engine_window_set_vsync(engine_settings_get()->vsync);
+}
 
 // Init
 bool engine_init() {
 
+    // Mount the resource pack if there is one, loose files still override it
+    pack_open(PACK_DEFAULT_PATH);
+
+    // Load the settings, invalid or missing values fall back to defaults
+    engine_settings_load(SETTINGS_DEFAULT_PATH);
+
+    // Hot reload, runs without it if the platform has no file watching
+    engine_watch_init();
+
     // Initialize the window
     if (!engine_init_window()) {
         printf("ERROR: Window creation failed!\n");
@@ -20,22 +48,59 @@ bool engine_init() {
         return false;
     }
 
+    // Profiler, uses GL timer queries
+    engine_trace_init();
+    engine_profiler_init();
+
+    // Per frame memory
+    engine_init_frame_arena();
+
     // Initialize input systems
     engine_input_init_char_buffer();
     engine_input_init_key_buffer();
 
+    // Watch the config
+    engine_watch_add(SETTINGS_DEFAULT_PATH, engine_reload_settings, NULL);
+
     return true;
 }
 
 void engine_terminate() {
 
+    // Finish a recording or replay still running
+    engine_replay_stop();
+
+    // How well the frame cap held
+    engine_pacing_report();
+
     // Terminate the input system
     engine_input_free_char_buffer();
     engine_input_free_key_buffer();
 
+    // Release the frame memory
+    engine_free_frame_arena();
+
+    // Terminate the profiler
+    engine_profiler_terminate();
+
     // Terminate the renderer
     engine_terminate_renderer();
 
+    // Terminate the file watcher
+    engine_watch_terminate();
+
     // Terminate the window
     engine_terminate_window();
+
+    // Write out a trace still being recorded, every worker thread is done by now
+    engine_trace_terminate();
+
+    // Release interned strings
+    intern_free();
+
+    // Release the main thread's scratch memory
+    arena_scratch_free();
+
+    // Unmount the resource pack
+    pack_close();
 }
\ No newline at end of file
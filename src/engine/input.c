@@ -1,6 +1,8 @@
 #include "input.h"
 
 #include "window.h"
+#include "replay.h"
+#include "engine.h"
 
 
 // Statics
@@ -14,14 +16,67 @@ static double mouse_scroll_input_[2];
 static MouseButtonInput mouse_button_input_;
 
 // Char input
-static LIST_TYPE(char) char_input_buffer_;
+static VECTOR(char) char_input_buffer_;
 
 // Key input
-static LIST_TYPE(KeyAction) key_input_buffer_;
+static VECTOR(KeyAction) key_input_buffer_;
 
-// Callbacks
+static bool keys_down_[GLFW_KEY_LAST + 1];
+
+// Callbacks, live input is ignored while a replay feeds the events. Any input wakes an idle engine for a frame
 void engine_input_mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
-    if (button >= INPUT_MAX_MOUSE_BUTTON) {
+    if (engine_replay_mode() == REPLAY_MODE_PLAY) {
+        return;
+    }
+
+    engine_replay_event(REPLAY_EVENT_MOUSE_BUTTON, button, action);
+    engine_input_mouse_button(button, action);
+
+    engine_request_redraw();
+}
+
+void engine_input_char_input_callback(GLFWwindow* window, unsigned int codepoint) {
+    if (engine_replay_mode() == REPLAY_MODE_PLAY) {
+        return;
+    }
+
+    engine_replay_event(REPLAY_EVENT_CHAR, codepoint, 0);
+    engine_input_char(codepoint);
+
+    engine_request_redraw();
+}
+
+void engine_input_key_input_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (engine_replay_mode() == REPLAY_MODE_PLAY) {
+        return;
+    }
+
+    engine_replay_event(REPLAY_EVENT_KEY, key, action);
+    engine_input_key(key, action);
+
+    engine_request_redraw();
+}
+
+void engine_input_scroll_input_callback(GLFWwindow* window, double xoffset, double yoffset) {
+    if (engine_replay_mode() == REPLAY_MODE_PLAY) {
+        return;
+    }
+
+    engine_replay_event(REPLAY_EVENT_SCROLL, xoffset, yoffset);
+    engine_input_scroll(xoffset, yoffset);
+
+    engine_request_redraw();
+}
+
+void engine_input_cursor_pos_callback(GLFWwindow* window, double x, double y) {
+
+    // The position itself is sampled once per frame
+    engine_request_redraw();
+}
+
+// Events
+void engine_input_mouse_button(int32_t button, int32_t action) {
+    if (button < 0 || button >= INPUT_MAX_MOUSE_BUTTON) {
         return;
     }
 
@@ -36,15 +91,19 @@ void engine_input_mouse_button_callback(GLFWwindow* window, int button, int acti
     }
 }
 
-void engine_input_char_input_callback(GLFWwindow* window, unsigned int codepoint) {
+void engine_input_char(uint32_t codepoint) {
 
-    LIST_PUSH(char_input_buffer_, codepoint);
+    VECTOR_PUSH(&char_input_buffer_, codepoint);
 }
 
-void engine_input_key_input_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
+void engine_input_key(int32_t key, int32_t action) {
+
+    if (key >= 0 && key <= GLFW_KEY_LAST) {
+        keys_down_[key] = (action != GLFW_RELEASE);
+    }
 
-    LIST_PUSH(
-        key_input_buffer_, 
+    VECTOR_PUSH(
+        &key_input_buffer_, 
         ((KeyAction) {
             .key = key,
             .state = action
@@ -52,7 +111,7 @@ void engine_input_key_input_callback(GLFWwindow* window, int key, int scancode,
     );
 }
 
-void engine_input_scroll_input_callback(GLFWwindow* window, double xoffset, double yoffset) {
+void engine_input_scroll(double xoffset, double yoffset) {
 
     mouse_scroll_input_[0] = xoffset;
     mouse_scroll_input_[1] = yoffset;
@@ -74,8 +133,19 @@ MouseButtonAction engine_input_get_mouse_button(uint32_t index) { // NOTE: Not s
 
 // Cursor pos
 void engine_input_update_cursor_pos() {
+    if (engine_replay_mode() == REPLAY_MODE_PLAY) {
+        return;
+    }
+
     glfwGetCursorPos(engine_glfw_window(), &cursor_pos_[0], &cursor_pos_[1]);
     cursor_pos_[1] = engine_window_get_size().y - cursor_pos_[1];
+
+    engine_replay_event(REPLAY_EVENT_CURSOR, cursor_pos_[0], cursor_pos_[1]);
+}
+
+void engine_input_set_cursor_pos(double x, double y) {
+    cursor_pos_[0] = x;
+    cursor_pos_[1] = y;
 }
 
 const double* engine_input_get_cursor_pos() {
@@ -94,34 +164,44 @@ const double* engine_input_get_mouse_scroll() {
 
 // Char input
 void engine_input_init_char_buffer() {
-    char_input_buffer_ = LIST_NEW(char_input_buffer_, char);
+    VECTOR_INIT(&char_input_buffer_, NULL);
+    VECTOR_RESERVE(&char_input_buffer_, 32);
 }
 
 void engine_input_free_char_buffer() {
-    LIST_FREE(char_input_buffer_);
+    VECTOR_FREE(&char_input_buffer_);
 }
 
 void engine_input_clear_char_input() {
-    LIST_CLEAR(char_input_buffer_);
+    VECTOR_CLEAR(&char_input_buffer_);
 }
 
-LIST_TYPE(char) engine_input_get_chars_pressed() {
-    return char_input_buffer_;
+const VECTOR(char)* engine_input_get_chars_pressed() {
+    return &char_input_buffer_;
 }
 
 // Key input
 void engine_input_init_key_buffer() {
-    key_input_buffer_ = LIST_NEW(key_input_buffer_, KeyAction);
+    VECTOR_INIT(&key_input_buffer_, NULL);
+    VECTOR_RESERVE(&key_input_buffer_, 32);
 }
 
 void engine_input_free_key_buffer() {
-    LIST_FREE(key_input_buffer_);
+    VECTOR_FREE(&key_input_buffer_);
 }
 
 void engine_input_clear_key_input() {
-    LIST_CLEAR(key_input_buffer_);
+    VECTOR_CLEAR(&key_input_buffer_);
+}
+
+const VECTOR(KeyAction)* engine_input_get_keys_pressed() {
+    return &key_input_buffer_;
 }
 
-LIST_TYPE(KeyAction) engine_input_get_keys_pressed() {
-    return key_input_buffer_;
+bool engine_input_key_down(int32_t key) {
+    if (key < 0 || key > GLFW_KEY_LAST) {
+        return false;
+    }
+
+    return keys_down_[key];
 }
\ No newline at end of file
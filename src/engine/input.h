@@ -1,7 +1,7 @@
 #pragma once
 
 #include "util/common.h"
-#include "util/list.h"
+#include "util/vector.h"
 
 // Max mouse button allowed
 #define INPUT_MAX_MOUSE_BUTTON 8
@@ -29,8 +29,8 @@ typedef struct KeyAction {
     int32_t state;
 } KeyAction;
 
-// List definitons
-LIST_DECLARE(KeyAction);
+// Vector definitons
+VECTOR_DECLARE(KeyAction, 0);
 
 // Callbacks
 void engine_input_mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
@@ -41,6 +41,17 @@ void engine_input_key_input_callback(GLFWwindow* window, int key, int scancode,
 
 void engine_input_scroll_input_callback(GLFWwindow* window, double xoffset, double yoffset);
 
+void engine_input_cursor_pos_callback(GLFWwindow* window, double x, double y);
+
+// Events, fed by the callbacks or a replay
+void engine_input_mouse_button(int32_t button, int32_t action);
+
+void engine_input_char(uint32_t codepoint);
+
+void engine_input_key(int32_t key, int32_t action);
+
+void engine_input_scroll(double xoffset, double yoffset);
+
 // Mouse button
 void engine_input_clear_mouse_button_input();
 
@@ -49,6 +60,8 @@ MouseButtonAction engine_input_get_mouse_button(uint32_t index);
 // Cursor position
 void engine_input_update_cursor_pos();
 
+void engine_input_set_cursor_pos(double x, double y);
+
 const double* engine_input_get_cursor_pos();
 
 // Mouse scroll
@@ -63,7 +76,7 @@ void engine_input_free_char_buffer();
 
 void engine_input_clear_char_input();
 
-LIST_TYPE(char) engine_input_get_chars_pressed();
+const VECTOR(char)* engine_input_get_chars_pressed();
 
 // Key input
 void engine_input_init_key_buffer();
@@ -72,4 +85,6 @@ void engine_input_free_key_buffer();
 
 void engine_input_clear_key_input();
 
-LIST_TYPE(KeyAction) engine_input_get_keys_pressed();
\ No newline at end of file
+const VECTOR(KeyAction)* engine_input_get_keys_pressed();
+
+bool engine_input_key_down(int32_t key); // Held since its press event, replaces glfwGetKey
\ No newline at end of file
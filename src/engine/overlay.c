@@ -0,0 +1,222 @@
+#include "overlay.h"
+
+#include "engine.h"
+#include "renderer.h"
+#include "shader.h"
+#include "profiler.h"
+#include "pacing.h"
+
+#include <stdarg.h>
+
+
+// Defines
+#define OVERLAY_LINE_SPACING    1.4f
+#define OVERLAY_GRAPH_HEIGHT    60.0f
+#define OVERLAY_GRAPH_BAR_WIDTH 2.0f
+#define OVERLAY_GRAPH_MAX_MS    50.0
+
+// Overlay state
+typedef struct OverlayCursor {
+    Font* font;
+    vec2s pos;
+    float scale;
+    float line_height;
+} OverlayCursor;
+
+// Visibility
+static bool visible_;
+
+// Static
+static void engine_overlay_line(OverlayCursor* cursor, const char* format, ...) {
+    char buffer[128];
+
+    va_list args;
+    va_start(args, format);
+    vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    cursor->pos.y -= cursor->line_height;
+
+    engine_render_text(
+        cursor->font, 
+        (vec3) {cursor->pos.x, cursor->pos.y, -1.0}, 
+        buffer, COLOR_WHITE, cursor->scale
+    );
+}
+
+static void engine_overlay_graph(OverlayCursor* cursor) {
+
+    Shader shader = engine_renderer_quad_shader();
+    engine_shader_bind(shader);
+
+    float bottom = cursor->pos.y - OVERLAY_GRAPH_HEIGHT - cursor->line_height * 0.5f;
+    uint32_t count = engine_profiler_history_count();
+
+    // Background, then one bar per frame with the newest on the right
+    engine_shader_vec4(shader, "u_color", (vec4) {0.0, 0.0, 0.0, 0.5});
+    engine_render_quad(
+        NULL, NULL, 
+        (vec3) {cursor->pos.x, bottom, -1.0}, 
+        (vec2) {PROFILER_HISTORY * OVERLAY_GRAPH_BAR_WIDTH, OVERLAY_GRAPH_HEIGHT}
+    );
+
+    for (uint32_t age = 0; age < count; ++age) {
+        double ms = engine_profiler_frame_time(age);
+
+        // Green within 60 Hz, yellow within 30 Hz, red above
+        if (ms <= 1000.0 / 60.0) {
+            engine_shader_vec4(shader, "u_color", (vec4) {0.2, 0.9, 0.3, 1.0});
+        } else if (ms <= 1000.0 / 30.0) {
+            engine_shader_vec4(shader, "u_color", (vec4) {0.9, 0.8, 0.2, 1.0});
+        } else {
+            engine_shader_vec4(shader, "u_color", (vec4) {0.9, 0.2, 0.2, 1.0});
+        }
+
+        float height = (float) ((ms < OVERLAY_GRAPH_MAX_MS) ? ms : OVERLAY_GRAPH_MAX_MS) / OVERLAY_GRAPH_MAX_MS * OVERLAY_GRAPH_HEIGHT;
+
+        engine_render_quad(
+            NULL, NULL, 
+            (vec3) {cursor->pos.x + (PROFILER_HISTORY - 1 - age) * OVERLAY_GRAPH_BAR_WIDTH, bottom, -1.0}, 
+            (vec2) {OVERLAY_GRAPH_BAR_WIDTH, height}
+        );
+    }
+
+    engine_shader_vec4(shader, "u_color", (vec4) {1.0, 1.0, 1.0, 1.0});
+    engine_shader_unbind(shader);
+
+    cursor->pos.y = bottom - cursor->line_height * 0.5f;
+}
+
+static void engine_overlay_profiler(OverlayCursor* cursor) {
+
+    ProfilerPercentiles percentiles = engine_profiler_percentiles();
+    engine_overlay_line(
+        cursor, "Frame: %.2f ms, p50 %.2f, p95 %.2f, p99 %.2f, max %.2f", 
+        engine_profiler_frame_time(0), percentiles.p50, percentiles.p95, percentiles.p99, percentiles.max
+    );
+
+    engine_overlay_graph(cursor);
+
+    // Spacing between frame starts, the wait for the cap included
+    PacingStats pacing = engine_pacing_stats();
+    if (pacing.target) {
+        engine_overlay_line(
+            cursor, "Pacing: %u fps cap, %.2f ms avg, jitter %.3f ms, worst %.3f ms, spin %.2f ms", 
+            pacing.target, pacing.average, pacing.jitter, pacing.worst, pacing.margin
+        );
+    } else {
+        engine_overlay_line(
+            cursor, "Pacing: uncapped, %.2f ms avg, jitter %.3f ms", 
+            pacing.average, pacing.jitter
+        );
+    }
+
+    // CPU scopes, indented by nesting
+    uint32_t count;
+    const ProfilerScope* scopes = engine_profiler_scopes(&count);
+    for (uint32_t i = 0; i < count; ++i) {
+        engine_overlay_line(
+            cursor, "%*s%s: %.3f ms (avg %.3f)", 
+            (int) (scopes[i].depth + 1) * 2, "", scopes[i].name, scopes[i].time, scopes[i].average
+        );
+    }
+
+    const ProfilerPass* passes = engine_profiler_passes(&count);
+    for (uint32_t i = 0; i < count; ++i) {
+        engine_overlay_line(
+            cursor, "  gpu %s: %.3f ms (avg %.3f)", 
+            passes[i].name, passes[i].time, passes[i].average
+        );
+    }
+}
+
+static void engine_overlay_counters(OverlayCursor* cursor) {
+
+    // Previous frame, the overlay's own text included
+    RenderCounters total = engine_renderer_counters_total();
+    engine_overlay_line(
+        cursor, "Render: %u draws, %u vertices, %u texture binds, %u program binds", 
+        total.draw_calls, total.vertices, total.texture_binds, total.program_binds
+    );
+    engine_overlay_line(
+        cursor, "  %u uniform uploads, %u buffer uploads", 
+        total.uniform_uploads, total.buffer_uploads
+    );
+
+    for (int32_t i = 0; i < RENDER_CATEGORY_COUNT; ++i) {
+        RenderCounters counters = engine_renderer_counters(i);
+        if (!counters.draw_calls && !counters.buffer_uploads) {
+            continue;
+        }
+
+        engine_overlay_line(
+            cursor, "  %s: %u draws, %u binds, %u uniforms", 
+            engine_renderer_category_name(i), counters.draw_calls, 
+            counters.texture_binds + counters.program_binds, counters.uniform_uploads
+        );
+    }
+}
+
+static double engine_overlay_mb(int64_t bytes) {
+    return bytes / (1024.0 * 1024.0);
+}
+
+static void engine_overlay_memory(OverlayCursor* cursor) {
+
+    HeapStats total = heap_get_total();
+
+#ifdef CTILED_MEMORY_TRACKING
+    engine_overlay_line(
+        cursor, "Heap: %.2f MB (peak %.2f MB), %" PRIu64 " live allocations", 
+        engine_overlay_mb(total.live_bytes), engine_overlay_mb(total.peak_bytes), total.allocations - total.frees
+    );
+
+    for (int32_t i = 0; i < HEAP_TAG_COUNT; ++i) {
+        HeapStats stats = heap_get_stats(i);
+        if (!stats.allocations && !stats.live_bytes) {
+            continue;
+        }
+
+        engine_overlay_line(
+            cursor, "  %s: %.2f MB (peak %.2f MB)", 
+            heap_tag_name(i), engine_overlay_mb(stats.live_bytes), engine_overlay_mb(stats.peak_bytes)
+        );
+    }
+#else
+    engine_overlay_line(cursor, "Heap: %" PRIu64 " allocations, %" PRIu64 " frees", total.allocations, total.frees);
+#endif
+
+    HeapStats gpu = heap_get_gpu();
+    engine_overlay_line(
+        cursor, "GPU: ~%.2f MB (peak %.2f MB)", 
+        engine_overlay_mb(gpu.live_bytes), engine_overlay_mb(gpu.peak_bytes)
+    );
+
+    engine_overlay_line(cursor, "Frame: %" PRIu64 " heap allocations", engine_frame_heap_allocations());
+}
+
+// Visibility
+void engine_overlay_toggle() {
+    visible_ = !visible_;
+}
+
+bool engine_overlay_visible() {
+    return visible_;
+}
+
+// Render
+void engine_overlay_render(Font* font, vec2s top_left, float scale) {
+
+    OverlayCursor cursor = (OverlayCursor) {
+        .font = font,
+        .pos = top_left,
+        .scale = scale,
+        .line_height = engine_font_get_text_size(font, "Ag", scale).y * OVERLAY_LINE_SPACING,
+    };
+
+    engine_overlay_profiler(&cursor);
+
+    engine_overlay_counters(&cursor);
+
+    engine_overlay_memory(&cursor);
+}
\ No newline at end of file
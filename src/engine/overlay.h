@@ -0,0 +1,14 @@
+#pragma once
+
+#include "util/common.h"
+
+#include "font.h"
+
+
+// Visibility
+void engine_overlay_toggle();
+
+bool engine_overlay_visible();
+
+// Render, lines go down from the top left corner
+void engine_overlay_render(Font* font, vec2s top_left, float scale);
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "pacing.h"
+
+#include "settings.h"
+#include "window.h"
+
+#include <time.h>
+
+
+// Target
+static int32_t target_ = PACING_FROM_SETTINGS;
+
+// Schedule
+static double deadline_;
+static double margin_ = PACING_MAX_MARGIN;
+
+// History
+static double history_[PACING_HISTORY];
+static uint32_t history_head_;
+static uint32_t history_count_;
+static double last_frame_;
+
+// Static
+static void engine_pacing_sleep(double seconds) {
+    struct timespec time = (struct timespec) {
+        .tv_sec = (time_t) seconds,
+        .tv_nsec = (long) ((seconds - (time_t) seconds) * 1e9),
+    };
+
+    nanosleep(&time, NULL);
+}
+
+static void engine_pacing_record(double now) {
+    if (last_frame_ > 0.0) {
+        history_[history_head_] = (now - last_frame_) * 1000.0;
+        history_head_ = (history_head_ + 1) % PACING_HISTORY;
+
+        if (history_count_ < PACING_HISTORY) {
+            history_count_++;
+        }
+    }
+
+    last_frame_ = now;
+}
+
+// Target
+void engine_pacing_set_target(int32_t fps) {
+    target_ = fps;
+}
+
+uint32_t engine_pacing_target() {
+
+    // Offline rendering has nobody to pace for
+    if (engine_window_headless()) {
+        return 0;
+    }
+
+    int32_t target = (target_ == PACING_FROM_SETTINGS) ? engine_settings_get()->fps_limit : target_;
+    return (target > 0) ? (uint32_t) target : 0;
+}
+
+// Frame
+void engine_pacing_wait() {
+
+    uint32_t target = engine_pacing_target();
+    double now = glfwGetTime();
+
+    if (target) {
+        double period = 1.0 / target;
+        deadline_ += period;
+
+        // More than a frame behind or ahead (target changed, stalls), don't try to catch up
+        if (deadline_ < now - period || deadline_ > now + period) {
+            deadline_ = now;
+        }
+
+        // Sleep most of the way, the scheduler wakes up late so the margin is spun
+        double sleep = deadline_ - now - margin_;
+        if (sleep > 0.0) {
+            engine_pacing_sleep(sleep);
+
+            double woke = glfwGetTime();
+            double late = (woke - now) - sleep;
+
+            // Jump to a late wake-up right away, relax back slowly
+            margin_ = (late > margin_) ? late : margin_ * 0.99 + late * 0.01;
+            margin_ = fmin(fmax(margin_, PACING_MIN_MARGIN), PACING_MAX_MARGIN);
+
+            now = woke;
+        }
+
+        while (now < deadline_) {
+            now = glfwGetTime();
+        }
+    }
+
+    engine_pacing_record(now);
+}
+
+void engine_pacing_reset() {
+    deadline_ = glfwGetTime();
+    last_frame_ = 0.0;
+}
+
+// Results
+PacingStats engine_pacing_stats() {
+
+    PacingStats stats = (PacingStats) {
+        .target = engine_pacing_target(),
+        .count = history_count_,
+        .margin = margin_ * 1000.0,
+    };
+
+    if (!history_count_) {
+        return stats;
+    }
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < history_count_; ++i) {
+        sum += history_[i];
+    }
+    stats.average = sum / history_count_;
+
+    double expected = (stats.target) ? 1000.0 / stats.target : stats.average;
+    double variance = 0.0;
+    for (uint32_t i = 0; i < history_count_; ++i) {
+        double error = fabs(history_[i] - expected);
+        if (error > stats.worst) {
+            stats.worst = error;
+        }
+
+        variance += (history_[i] - stats.average) * (history_[i] - stats.average);
+    }
+    stats.jitter = sqrt(variance / history_count_);
+
+    return stats;
+}
+
+void engine_pacing_report() {
+
+    PacingStats stats = engine_pacing_stats();
+    if (!stats.target || !stats.count) {
+        return;
+    }
+
+    printf(
+        "INFO: Frame pacing at %u fps, %.3f ms average, %.3f ms jitter, %.3f ms worst (last %u frames).\n", 
+        stats.target, stats.average, stats.jitter, stats.worst, stats.count
+    );
+}
\ No newline at end of file
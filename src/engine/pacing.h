@@ -0,0 +1,36 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Defines
+#define PACING_HISTORY          240     // Frames
+#define PACING_FROM_SETTINGS    -1      // Target follows window.fps-limit
+#define PACING_MIN_MARGIN       0.0002  // Seconds spun at the end of every wait, at least
+#define PACING_MAX_MARGIN       0.004
+
+// Achieved frame intervals over the history, in milliseconds
+typedef struct PacingStats {
+    uint32_t target; // Frames per second, 0 when uncapped
+    uint32_t count;
+
+    double average;
+    double jitter; // Standard deviation of the intervals
+    double worst; // Largest distance from the target interval, or from the average when uncapped
+    double margin; // Current spin margin
+} PacingStats;
+
+// Target
+void engine_pacing_set_target(int32_t fps); // 0 uncaps, PACING_FROM_SETTINGS goes back to the config
+
+uint32_t engine_pacing_target();
+
+// Frame, called by engine_poll_events right before the input is sampled
+void engine_pacing_wait();
+
+void engine_pacing_reset(); // Starts a new schedule, after the loop slept for other reasons
+
+// Results
+PacingStats engine_pacing_stats();
+
+void engine_pacing_report();
\ No newline at end of file
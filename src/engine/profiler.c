@@ -0,0 +1,302 @@
+#include "profiler.h"
+
+#include "trace.h"
+
+#include "util/util.h"
+
+
+// Query set, passes issued during one frame
+typedef struct ProfilerQuerySet {
+    uint32_t queries[PROFILER_MAX_PASSES];
+    uint32_t passes[PROFILER_MAX_PASSES]; // Index into passes_
+    double starts[PROFILER_MAX_PASSES]; // CPU time the pass was issued at
+    uint32_t count;
+} ProfilerQuerySet;
+
+// Open CPU scope
+typedef struct ProfilerOpen {
+    const char* name;
+    uint32_t scope;
+    double start;
+} ProfilerOpen;
+
+// Scopes
+static ProfilerScope scopes_[PROFILER_MAX_SCOPES];
+static uint32_t scope_count_;
+
+static ProfilerOpen stack_[PROFILER_MAX_DEPTH];
+static uint32_t depth_;
+
+// Passes, query sets alternate between frames so reading them back doesn't stall
+static ProfilerPass passes_[PROFILER_MAX_PASSES];
+static uint32_t pass_count_;
+
+static ProfilerQuerySet query_sets_[2];
+static uint32_t query_set_;
+static bool gpu_active_;
+static bool gpu_ready_;
+
+// Frame history
+static double history_[PROFILER_HISTORY];
+static uint32_t history_head_;
+static uint32_t history_count_;
+static double frame_start_;
+
+// Static
+static double engine_profiler_now() {
+    return glfwGetTime() * 1000.0;
+}
+
+static double engine_profiler_smooth(double average, double value) {
+    return (average == 0.0) ? value : average * 0.9 + value * 0.1;
+}
+
+static uint32_t engine_profiler_find_scope(const char* name) {
+
+    // Names are usually literals, compare the pointers first
+    for (uint32_t i = 0; i < scope_count_; ++i) {
+        if (scopes_[i].name == name || strcmp(scopes_[i].name, name) == STR_EQUAL) {
+            return i;
+        }
+    }
+
+    if (scope_count_ == PROFILER_MAX_SCOPES) {
+        return PROFILER_MAX_SCOPES;
+    }
+
+    scopes_[scope_count_] = (ProfilerScope) {
+        .name = name,
+        .depth = depth_,
+    };
+
+    return scope_count_++;
+}
+
+static uint32_t engine_profiler_find_pass(const char* name) {
+    for (uint32_t i = 0; i < pass_count_; ++i) {
+        if (passes_[i].name == name || strcmp(passes_[i].name, name) == STR_EQUAL) {
+            return i;
+        }
+    }
+
+    if (pass_count_ == PROFILER_MAX_PASSES) {
+        return PROFILER_MAX_PASSES;
+    }
+
+    passes_[pass_count_] = (ProfilerPass) {
+        .name = name,
+    };
+
+    return pass_count_++;
+}
+
+static void engine_profiler_read_queries(ProfilerQuerySet* set) {
+
+    for (uint32_t i = 0; i < set->count; ++i) {
+
+        // Still in flight, drop the sample rather than wait for it
+        int32_t available = 0;
+        glGetQueryObjectiv(set->queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            continue;
+        }
+
+        uint64_t nanoseconds = 0;
+        glGetQueryObjectui64v(set->queries[i], GL_QUERY_RESULT, &nanoseconds);
+
+        ProfilerPass* pass = &passes_[set->passes[i]];
+        pass->time = nanoseconds / 1e6;
+        pass->average = engine_profiler_smooth(pass->average, pass->time);
+
+        // Only the duration is known, the trace places it where the CPU issued the pass
+        engine_trace_gpu(pass->name, set->starts[i] * 1000.0, pass->time * 1000.0);
+    }
+
+    set->count = 0;
+}
+
+static int engine_profiler_compare(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+
+    return (x > y) - (x < y);
+}
+
+// Init
+void engine_profiler_init() {
+    for (uint32_t i = 0; i < 2; ++i) {
+        glGenQueries(PROFILER_MAX_PASSES, query_sets_[i].queries);
+        query_sets_[i].count = 0;
+    }
+
+    gpu_ready_ = true;
+}
+
+void engine_profiler_terminate() {
+    if (!gpu_ready_) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < 2; ++i) {
+        glDeleteQueries(PROFILER_MAX_PASSES, query_sets_[i].queries);
+    }
+
+    gpu_ready_ = false;
+}
+
+// Frame
+void engine_profiler_frame() {
+
+    if (depth_ != 0) {
+        printf("WARNING: Profiler scope '%s' was not closed before the end of the frame.\n", scopes_[stack_[depth_ - 1].scope].name);
+        depth_ = 0;
+    }
+
+    // Frame time, the first call only starts the clock
+    double now = engine_profiler_now();
+
+    if (frame_start_ > 0.0) {
+        engine_trace_complete("frame", frame_start_ * 1000.0, (now - frame_start_) * 1000.0);
+
+        history_[history_head_] = now - frame_start_;
+        history_head_ = (history_head_ + 1) % PROFILER_HISTORY;
+        if (history_count_ < PROFILER_HISTORY) {
+            history_count_++;
+        }
+    }
+
+    frame_start_ = now;
+
+    // Publish the scopes
+    for (uint32_t i = 0; i < scope_count_; ++i) {
+        ProfilerScope* scope = &scopes_[i];
+
+        scope->time = scope->accumulated_;
+        scope->calls = scope->accumulated_calls_;
+        scope->average = engine_profiler_smooth(scope->average, scope->time);
+
+        scope->accumulated_ = 0.0;
+        scope->accumulated_calls_ = 0;
+    }
+
+    // The other set was issued a frame earlier, it's usually done by now
+    if (gpu_ready_) {
+        query_set_ ^= 1;
+        engine_profiler_read_queries(&query_sets_[query_set_]);
+    }
+
+    engine_trace_frame();
+}
+
+// CPU scopes
+void engine_profiler_begin(const char* name) {
+    if (depth_ == PROFILER_MAX_DEPTH) {
+        printf("ERROR: Profiler scope '%s' is nested too deep.\n", name);
+        return;
+    }
+
+    uint32_t scope = engine_profiler_find_scope(name);
+
+    stack_[depth_++] = (ProfilerOpen) {
+        .name = name,
+        .scope = scope,
+        .start = engine_profiler_now(),
+    };
+
+    engine_trace_begin(name);
+}
+
+void engine_profiler_end() {
+    if (depth_ == 0) {
+        printf("ERROR: Profiler scope ended without a matching begin.\n");
+        return;
+    }
+
+    ProfilerOpen* open = &stack_[--depth_];
+    engine_trace_end(open->name);
+
+    if (open->scope == PROFILER_MAX_SCOPES) {
+        return;
+    }
+
+    ProfilerScope* scope = &scopes_[open->scope];
+    scope->accumulated_ += engine_profiler_now() - open->start;
+    scope->accumulated_calls_++;
+}
+
+// GPU passes
+void engine_profiler_gpu_begin(const char* name) {
+    if (!gpu_ready_) {
+        return;
+    }
+
+    if (gpu_active_) {
+        printf("ERROR: GPU pass '%s' started inside another pass.\n", name);
+        return;
+    }
+
+    ProfilerQuerySet* set = &query_sets_[query_set_];
+    uint32_t pass = engine_profiler_find_pass(name);
+
+    if (set->count == PROFILER_MAX_PASSES || pass == PROFILER_MAX_PASSES) {
+        return;
+    }
+
+    set->passes[set->count] = pass;
+    set->starts[set->count] = engine_profiler_now();
+    glBeginQuery(GL_TIME_ELAPSED, set->queries[set->count]);
+    set->count++;
+
+    gpu_active_ = true;
+}
+
+void engine_profiler_gpu_end() {
+    if (!gpu_active_) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    gpu_active_ = false;
+}
+
+// Results
+const ProfilerScope* engine_profiler_scopes(uint32_t* count) {
+    *count = scope_count_;
+    return scopes_;
+}
+
+const ProfilerPass* engine_profiler_passes(uint32_t* count) {
+    *count = pass_count_;
+    return passes_;
+}
+
+uint32_t engine_profiler_history_count() {
+    return history_count_;
+}
+
+double engine_profiler_frame_time(uint32_t age) {
+    if (age >= history_count_) {
+        return 0.0;
+    }
+
+    return history_[(history_head_ + PROFILER_HISTORY - 1 - age) % PROFILER_HISTORY];
+}
+
+ProfilerPercentiles engine_profiler_percentiles() {
+    if (history_count_ == 0) {
+        return (ProfilerPercentiles) {0};
+    }
+
+    double sorted[PROFILER_HISTORY];
+    memcpy(sorted, history_, sizeof(double) * history_count_);
+    qsort(sorted, history_count_, sizeof(double), engine_profiler_compare);
+
+    // Nearest rank
+    uint32_t last = history_count_ - 1;
+    return (ProfilerPercentiles) {
+        .p50 = sorted[(last * 50 + 50) / 100],
+        .p95 = sorted[(last * 95 + 50) / 100],
+        .p99 = sorted[(last * 99 + 50) / 100],
+        .max = sorted[last],
+    };
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Defines
+#define PROFILER_MAX_SCOPES     32
+#define PROFILER_MAX_DEPTH      16
+#define PROFILER_MAX_PASSES     8
+#define PROFILER_HISTORY        240 // Frames
+
+// Named CPU scope, times are in milliseconds
+typedef struct ProfilerScope {
+    const char* name;
+    uint32_t depth; // Nesting depth the scope was first opened at
+
+    double time; // Last complete frame
+    double average;
+    uint32_t calls;
+
+    double accumulated_; // Current frame
+    uint32_t accumulated_calls_;
+} ProfilerScope;
+
+// GPU render pass, measured with GL_TIME_ELAPSED queries and read back one frame later
+typedef struct ProfilerPass {
+    const char* name;
+    double time;
+    double average;
+} ProfilerPass;
+
+// Frame time distribution over the history
+typedef struct ProfilerPercentiles {
+    double p50;
+    double p95;
+    double p99;
+    double max;
+} ProfilerPercentiles;
+
+// Init, GPU passes need a current GL context
+void engine_profiler_init();
+
+void engine_profiler_terminate();
+
+// Frame, called once per frame by engine_poll_events
+void engine_profiler_frame();
+
+// CPU scopes, main thread only, names must outlive the profiler
+void engine_profiler_begin(const char* name);
+
+void engine_profiler_end();
+
+// GPU passes, can't be nested
+void engine_profiler_gpu_begin(const char* name);
+
+void engine_profiler_gpu_end();
+
+// Results
+const ProfilerScope* engine_profiler_scopes(uint32_t* count);
+
+const ProfilerPass* engine_profiler_passes(uint32_t* count);
+
+uint32_t engine_profiler_history_count();
+
+double engine_profiler_frame_time(uint32_t age); // Milliseconds, 0 is the last complete frame
+
+ProfilerPercentiles engine_profiler_percentiles();
\ No newline at end of file
@@ -14,6 +14,19 @@ static Shader text_shader_;
 // Textures
 static Texture* quad_texture_;
 
+// Counters
+static RenderCounters counters_[RENDER_CATEGORY_COUNT];
+static RenderCounters last_counters_[RENDER_CATEGORY_COUNT];
+static int32_t category_;
+
+static const char* category_names_[RENDER_CATEGORY_COUNT] = {
+    "other",
+    "tiles",
+    "tilepicker",
+    "ui",
+    "text",
+};
+
 // Initialization & Termination
 bool engine_init_renderer() {
 
@@ -39,6 +52,7 @@ bool engine_init_renderer() {
     glGenBuffers(1, &vbo_);
     glBindBuffer(GL_ARRAY_BUFFER, vbo_);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertex_buffer), (const void*) vertex_buffer, GL_STATIC_DRAW);
+    RENDER_COUNT(buffer_uploads, 1);
 
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, vertex_size, NULL);
     glEnableVertexAttribArray(0);
@@ -49,6 +63,7 @@ bool engine_init_renderer() {
     glGenBuffers(1, &ebo_);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(index_buffer), (const void*) index_buffer, GL_STATIC_DRAW);
+    RENDER_COUNT(buffer_uploads, 1);
 
     // Unbind buffers
     glBindVertexArray(0);
@@ -91,6 +106,54 @@ Shader engine_renderer_quad_shader() {
     return quad_shader_;
 }
 
+// Counters
+int32_t engine_renderer_set_category(int32_t category) {
+    int32_t previous = category_;
+    category_ = (category >= 0 && category < RENDER_CATEGORY_COUNT) ? category : RENDER_CATEGORY_OTHER;
+
+    return previous;
+}
+
+RenderCounters* engine_renderer_current_counters() {
+    return &counters_[category_];
+}
+
+void engine_renderer_frame() {
+    memcpy(last_counters_, counters_, sizeof(counters_));
+    memset(counters_, 0, sizeof(counters_));
+}
+
+RenderCounters engine_renderer_counters(int32_t category) {
+    if (category < 0 || category >= RENDER_CATEGORY_COUNT) {
+        return (RenderCounters) {0};
+    }
+
+    return last_counters_[category];
+}
+
+RenderCounters engine_renderer_counters_total() {
+    RenderCounters total = {0};
+
+    for (int32_t i = 0; i < RENDER_CATEGORY_COUNT; ++i) {
+        total.draw_calls += last_counters_[i].draw_calls;
+        total.vertices += last_counters_[i].vertices;
+        total.texture_binds += last_counters_[i].texture_binds;
+        total.program_binds += last_counters_[i].program_binds;
+        total.uniform_uploads += last_counters_[i].uniform_uploads;
+        total.buffer_uploads += last_counters_[i].buffer_uploads;
+    }
+
+    return total;
+}
+
+const char* engine_renderer_category_name(int32_t category) {
+    if (category < 0 || category >= RENDER_CATEGORY_COUNT) {
+        return category_names_[RENDER_CATEGORY_OTHER];
+    }
+
+    return category_names_[category];
+}
+
 // Scissor Test
 void engine_renderer_set_scissor_box(int32_t x, int32_t y, int32_t w, int32_t h) {
     if (engine_window_get_retina()) {
@@ -164,6 +227,9 @@ void engine_render_quad(Texture* texture, vec4 source, vec3 position, vec2 size)
     
     glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
 
+    RENDER_COUNT(draw_calls, 1);
+    RENDER_COUNT(vertices, 6);
+
     // Unbind buffers
     glBindVertexArray(0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
@@ -177,6 +243,9 @@ void engine_render_text(Font* font, vec3 position, const char* text, vec3 color,
     // Advance
     float advance = 0;
 
+    // Glyphs count as text whoever draws them
+    int32_t category = engine_renderer_set_category(RENDER_CATEGORY_TEXT);
+
     // Bind the text shader
     engine_shader_bind(text_shader_);
 
@@ -187,7 +256,7 @@ void engine_render_text(Font* font, vec3 position, const char* text, vec3 color,
     for (const char* c = text; c < text + strlen(text); ++c) {
 
         // Get the character from font
-        const Character* chr = &font->characters[*c];
+        const Character* chr = &font->characters[(uint8_t) *c & 0x7F];
 
         float xpos = position[0] + advance + chr->bearing[0] * scale;
         float ypos = position[1] - (chr->size[1] - chr->bearing[1]) * scale;
@@ -198,6 +267,7 @@ void engine_render_text(Font* font, vec3 position, const char* text, vec3 color,
         // Bind the texture
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, chr->id);
+        RENDER_COUNT(texture_binds, 1);
 
         // Setup matrices
         vec2s win_size = engine_window_get_size();
@@ -225,6 +295,9 @@ void engine_render_text(Font* font, vec3 position, const char* text, vec3 color,
         
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
 
+        RENDER_COUNT(draw_calls, 1);
+        RENDER_COUNT(vertices, 6);
+
         // Add to advance
         advance += chr->advance * scale;
 
@@ -238,4 +311,6 @@ void engine_render_text(Font* font, vec3 position, const char* text, vec3 color,
 
     // Unbind the shader
     engine_shader_unbind(0);
+
+    engine_renderer_set_category(category);
 }
\ No newline at end of file
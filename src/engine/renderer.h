@@ -7,6 +7,27 @@
 #include "font.h"
 
 
+// Categories draws are attributed to
+#define RENDER_CATEGORY_OTHER       0
+#define RENDER_CATEGORY_TILES       1
+#define RENDER_CATEGORY_TILEPICKER  2
+#define RENDER_CATEGORY_UI          3
+#define RENDER_CATEGORY_TEXT        4
+#define RENDER_CATEGORY_COUNT       5
+
+// Work submitted to GL during a frame
+typedef struct RenderCounters {
+    uint32_t draw_calls;
+    uint32_t vertices;
+    uint32_t texture_binds;
+    uint32_t program_binds;
+    uint32_t uniform_uploads;
+    uint32_t buffer_uploads; // Buffer and texture data
+} RenderCounters;
+
+#define RENDER_COUNT(field, amount) \
+    (engine_renderer_current_counters()->field += (amount))
+
 // Initialization & Termination
 bool engine_init_renderer();
 
@@ -15,6 +36,19 @@ void engine_terminate_renderer();
 // Shaders
 Shader engine_renderer_quad_shader();
 
+// Counters, published once per frame by engine_poll_events
+int32_t engine_renderer_set_category(int32_t category); // Returns the previous category
+
+RenderCounters* engine_renderer_current_counters();
+
+void engine_renderer_frame();
+
+RenderCounters engine_renderer_counters(int32_t category); // Last complete frame
+
+RenderCounters engine_renderer_counters_total();
+
+const char* engine_renderer_category_name(int32_t category);
+
 // Scissor Test
 void engine_renderer_set_scissor_box(int32_t x, int32_t y, int32_t w, int32_t h);
 
@@ -0,0 +1,309 @@
+#include "replay.h"
+
+#include "input.h"
+#include "window.h"
+
+#include "util/file.h"
+
+
+// Defines
+#define REPLAY_HEADER_SIZE 16
+
+// State
+static int32_t mode_;
+static uint32_t frame_;
+static double start_time_;
+
+// Recording
+static FILE* file_;
+static double cursor_[2];
+
+// Playback
+static FileView view_;
+static size_t offset_;
+
+// Static
+static void engine_replay_put_u32(uint8_t* buffer, uint32_t value) {
+    buffer[0] = (uint8_t) (value);
+    buffer[1] = (uint8_t) (value >> 8);
+    buffer[2] = (uint8_t) (value >> 16);
+    buffer[3] = (uint8_t) (value >> 24);
+}
+
+static void engine_replay_put_f32(uint8_t* buffer, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    engine_replay_put_u32(buffer, bits);
+}
+
+static uint32_t engine_replay_get_u32(const uint8_t* buffer) {
+    return (uint32_t) buffer[0] | ((uint32_t) buffer[1] << 8) | ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[3] << 24);
+}
+
+static float engine_replay_get_f32(const uint8_t* buffer) {
+    uint32_t bits = engine_replay_get_u32(buffer);
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+
+    return value;
+}
+
+static size_t engine_replay_payload_size(int32_t type) {
+    switch (type) {
+        case REPLAY_EVENT_FRAME:        return 8;
+        case REPLAY_EVENT_MOUSE_BUTTON: return 2;
+        case REPLAY_EVENT_KEY:          return 3;
+        case REPLAY_EVENT_CHAR:         return 4;
+        case REPLAY_EVENT_SCROLL:       return 8;
+        case REPLAY_EVENT_CURSOR:       return 8;
+    }
+
+    return 0;
+}
+
+// Points at the next event's payload, NULL at the end of the file or on a broken event
+static const uint8_t* engine_replay_next(int32_t* type) {
+
+    const uint8_t* data = (const uint8_t*) view_.data;
+    if (offset_ >= view_.size) {
+        return NULL;
+    }
+
+    *type = data[offset_];
+
+    size_t size = engine_replay_payload_size(*type);
+    if (!size || offset_ + 1 + size > view_.size) {
+        printf("ERROR: Replay is corrupted at byte %zu (frame %u).\n", offset_, frame_);
+        return NULL;
+    }
+
+    const uint8_t* payload = data + offset_ + 1;
+    offset_ += 1 + size;
+
+    return payload;
+}
+
+static void engine_replay_finish() {
+    engine_replay_stop();
+
+    // A replay is a benchmark run, leave once it's done
+    glfwSetWindowShouldClose(engine_glfw_window(), true);
+}
+
+// Start & stop
+bool engine_replay_record(const char* path) {
+
+    if (mode_ != REPLAY_MODE_NONE) {
+        printf("ERROR: A replay is already being recorded or played.\n");
+        return false;
+    }
+
+    if (!(file_ = fopen(path, "wb"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        return false;
+    }
+
+    // Header, the window size decides where the recorded cursor positions land
+    vec2s size = engine_window_get_size();
+
+    uint8_t header[REPLAY_HEADER_SIZE];
+    memcpy(header, REPLAY_MAGIC, 4);
+    engine_replay_put_u32(header + 4, REPLAY_VERSION);
+    engine_replay_put_u32(header + 8, (uint32_t) size.x);
+    engine_replay_put_u32(header + 12, (uint32_t) size.y);
+    fwrite(header, 1, sizeof(header), file_);
+
+    mode_ = REPLAY_MODE_RECORD;
+    frame_ = 0;
+    start_time_ = glfwGetTime();
+
+    cursor_[0] = -1.0;
+    cursor_[1] = -1.0;
+
+    printf("Recording input to '%s'.\n", path);
+
+    return true;
+}
+
+bool engine_replay_play(const char* path) {
+
+    if (mode_ != REPLAY_MODE_NONE) {
+        printf("ERROR: A replay is already being recorded or played.\n");
+        return false;
+    }
+
+    if (!file_load(&view_, path, FILE_LOAD_READ)) {
+        return false;
+    }
+
+    const uint8_t* header = (const uint8_t*) view_.data;
+    if (view_.size < REPLAY_HEADER_SIZE || memcmp(header, REPLAY_MAGIC, 4) != 0) {
+        printf("ERROR: '%s' is not a replay.\n", path);
+        file_release(&view_);
+        return false;
+    }
+
+    uint32_t version = engine_replay_get_u32(header + 4);
+    if (version != REPLAY_VERSION) {
+        printf("ERROR: Replay '%s' has version %u, expected %u.\n", path, version, REPLAY_VERSION);
+        file_release(&view_);
+        return false;
+    }
+
+    vec2s size = engine_window_get_size();
+    uint32_t width = engine_replay_get_u32(header + 8);
+    uint32_t height = engine_replay_get_u32(header + 12);
+    if (width != (uint32_t) size.x || height != (uint32_t) size.y) {
+        printf("WARNING: Replay was recorded at %ux%u, the window is %.0fx%.0f.\n", width, height, size.x, size.y);
+    }
+
+    mode_ = REPLAY_MODE_PLAY;
+    frame_ = 0;
+    start_time_ = glfwGetTime();
+    offset_ = REPLAY_HEADER_SIZE;
+
+    printf("Replaying input from '%s'.\n", path);
+
+    return true;
+}
+
+void engine_replay_stop() {
+
+    double elapsed = glfwGetTime() - start_time_;
+
+    if (mode_ == REPLAY_MODE_RECORD) {
+        if (fclose(file_) != 0) {
+            printf("ERROR: Failed to write the replay.\n");
+        }
+        file_ = NULL;
+
+        printf("Recorded %u frames in %.2f s.\n", frame_, elapsed);
+    } else if (mode_ == REPLAY_MODE_PLAY) {
+        file_release(&view_);
+
+        printf(
+            "Replayed %u frames in %.2f s (%.3f ms per frame).\n", 
+            frame_, elapsed, (frame_) ? elapsed * 1000.0 / frame_ : 0.0
+        );
+    }
+
+    mode_ = REPLAY_MODE_NONE;
+}
+
+int32_t engine_replay_mode() {
+    return mode_;
+}
+
+// Frame
+double engine_replay_frame(double delta_time) {
+
+    if (mode_ == REPLAY_MODE_RECORD) {
+
+        // The session runs on the stored precision too, so a replay steps through the same ticks
+        float recorded = (float) delta_time;
+
+        uint8_t record[9] = { REPLAY_EVENT_FRAME };
+        engine_replay_put_u32(record + 1, frame_++);
+        engine_replay_put_f32(record + 5, recorded);
+        fwrite(record, 1, sizeof(record), file_);
+
+        return (double) recorded;
+    }
+
+    if (mode_ != REPLAY_MODE_PLAY) {
+        return delta_time;
+    }
+
+    // Events nobody polled for belong to the previous frame, skip to the next frame marker
+    int32_t type;
+    const uint8_t* payload;
+    while ((payload = engine_replay_next(&type))) {
+        if (type == REPLAY_EVENT_FRAME) {
+            frame_ = engine_replay_get_u32(payload) + 1;
+            return engine_replay_get_f32(payload + 4);
+        }
+    }
+
+    engine_replay_finish();
+
+    return delta_time;
+}
+
+// Events
+void engine_replay_apply() {
+
+    if (mode_ != REPLAY_MODE_PLAY) {
+        return;
+    }
+
+    // Everything up to the next frame marker, which is left for engine_replay_frame
+    const uint8_t* data = (const uint8_t*) view_.data;
+    while (offset_ < view_.size && data[offset_] != REPLAY_EVENT_FRAME) {
+
+        int32_t type;
+        const uint8_t* payload = engine_replay_next(&type);
+        if (!payload) {
+            engine_replay_finish();
+            return;
+        }
+
+        switch (type) {
+            case REPLAY_EVENT_MOUSE_BUTTON:
+                engine_input_mouse_button(payload[0], payload[1]);
+                break;
+            case REPLAY_EVENT_KEY:
+                engine_input_key((int16_t) (payload[0] | (payload[1] << 8)), payload[2]);
+                break;
+            case REPLAY_EVENT_CHAR:
+                engine_input_char(engine_replay_get_u32(payload));
+                break;
+            case REPLAY_EVENT_SCROLL:
+                engine_input_scroll(engine_replay_get_f32(payload), engine_replay_get_f32(payload + 4));
+                break;
+            case REPLAY_EVENT_CURSOR:
+                engine_input_set_cursor_pos(engine_replay_get_f32(payload), engine_replay_get_f32(payload + 4));
+                break;
+        }
+    }
+}
+
+void engine_replay_event(int32_t type, double a, double b) {
+
+    if (mode_ != REPLAY_MODE_RECORD) {
+        return;
+    }
+
+    uint8_t record[9] = { (uint8_t) type };
+
+    switch (type) {
+        case REPLAY_EVENT_MOUSE_BUTTON:
+            record[1] = (uint8_t) a;
+            record[2] = (uint8_t) b;
+            break;
+        case REPLAY_EVENT_KEY: {
+            int16_t key = (int16_t) a;
+            record[1] = (uint8_t) (key);
+            record[2] = (uint8_t) (key >> 8);
+            record[3] = (uint8_t) b;
+        } break;
+        case REPLAY_EVENT_CHAR:
+            engine_replay_put_u32(record + 1, (uint32_t) a);
+            break;
+        case REPLAY_EVENT_CURSOR:
+            if (a == cursor_[0] && b == cursor_[1]) {
+                return;
+            }
+            cursor_[0] = a;
+            cursor_[1] = b;
+            // Fallthrough
+        case REPLAY_EVENT_SCROLL:
+            engine_replay_put_f32(record + 1, (float) a);
+            engine_replay_put_f32(record + 5, (float) b);
+            break;
+        default:
+            return;
+    }
+
+    fwrite(record, 1, 1 + engine_replay_payload_size(type), file_);
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Defines
+#define REPLAY_MAGIC    "CTRP"
+#define REPLAY_VERSION  1
+
+// Modes
+#define REPLAY_MODE_NONE    0
+#define REPLAY_MODE_RECORD  1
+#define REPLAY_MODE_PLAY    2
+
+// Event types, each is a type byte followed by a little endian payload
+#define REPLAY_EVENT_FRAME          0 // u32 frame, f32 delta time, the events after it belong to that frame
+#define REPLAY_EVENT_MOUSE_BUTTON   1 // u8 button, u8 action
+#define REPLAY_EVENT_KEY            2 // i16 key, u8 action
+#define REPLAY_EVENT_CHAR           3 // u32 codepoint
+#define REPLAY_EVENT_SCROLL         4 // f32 x, f32 y
+#define REPLAY_EVENT_CURSOR         5 // f32 x, f32 y, only written when the cursor moved
+
+// Start & stop
+bool engine_replay_record(const char* path);
+
+bool engine_replay_play(const char* path);
+
+void engine_replay_stop();
+
+int32_t engine_replay_mode();
+
+// Frame, called by engine_calculate_delta_time
+double engine_replay_frame(double delta_time); // Returns the delta time to use, rounded as stored when recording, the recorded one when playing
+
+// Events, called by engine_poll_events
+void engine_replay_apply(); // Feeds the current frame's events to the input system when playing
+
+void engine_replay_event(int32_t type, double a, double b); // Writes a live event when recording
\ No newline at end of file
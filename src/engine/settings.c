@@ -0,0 +1,201 @@
+#include "settings.h"
+
+#include "parser/parser.h"
+
+#include "util/util.h"
+
+#include "window.h"
+
+#include <stddef.h>
+
+
+// Schema
+#define SETTINGS_FIELD(field_path, field_type, field, fallback_value, min_value, max_value) \
+    (SettingsField) { \
+        .path = field_path, \
+        .type = field_type, \
+        .offset = offsetof(EngineSettings, field), \
+        .fallback = fallback_value, \
+        .min = min_value, \
+        .max = max_value, \
+    }
+
+static const SettingsField schema_[] = {
+
+    // Window
+    SETTINGS_FIELD("window.width",       SETTINGS_TYPE_INT,  window_width,  800,   1, 16384),
+    SETTINGS_FIELD("window.height",      SETTINGS_TYPE_INT,  window_height, 600,   1, 16384),
+    SETTINGS_FIELD("window.vsync",       SETTINGS_TYPE_BOOL, vsync,         true,  0, 1),
+    SETTINGS_FIELD("window.fps-limit",   SETTINGS_TYPE_INT,  fps_limit,     0,     0, 1000),
+    SETTINGS_FIELD("window.idle-render", SETTINGS_TYPE_BOOL, idle_render,   true,  0, 1),
+    SETTINGS_FIELD("window.retina",      SETTINGS_TYPE_BOOL, retina,        false, 0, 1),
+    SETTINGS_FIELD("window.maximize",    SETTINGS_TYPE_BOOL, maximize,      false, 0, 1),
+    SETTINGS_FIELD("window.window-mode", SETTINGS_TYPE_INT,  window_mode,   WINDOW_MODE_WINDOWED, WINDOW_MODE_WINDOWED, WINDOW_MODE_WINDOWED_FULLSCREEN),
+    SETTINGS_FIELD("window.monitor",     SETTINGS_TYPE_INT,  monitor,       0,     0, 64),
+
+    // Level
+    SETTINGS_FIELD("level.level-size",   SETTINGS_TYPE_INT,  level_size,    512,   1, 16384),
+    SETTINGS_FIELD("level.tile-size",    SETTINGS_TYPE_INT,  tile_size,     32,    1, 512),
+};
+
+#define SETTINGS_FIELD_COUNT (sizeof(schema_) / sizeof(schema_[0]))
+
+// Settings
+static EngineSettings settings_;
+static bool loaded_ = false;
+
+// Static
+static void engine_settings_write(EngineSettings* settings, const SettingsField* field, int32_t value) {
+    void* target = (char*) settings + field->offset;
+
+    if (field->type == SETTINGS_TYPE_BOOL) {
+        *(bool*) target = (bool) value;
+    } else {
+        *(int32_t*) target = value;
+    }
+}
+
+static bool engine_settings_parse(const SettingsField* field, const char* text, int32_t* value) {
+
+    if (field->type == SETTINGS_TYPE_BOOL) {
+        if (strcmp(text, "true") == STR_EQUAL || strcmp(text, "1") == STR_EQUAL) {
+            *value = true;
+            return true;
+        } else if (strcmp(text, "false") == STR_EQUAL || strcmp(text, "0") == STR_EQUAL) {
+            *value = false;
+            return true;
+        }
+
+        printf("ERROR: Setting '%s' expects a bool, got '%s'.\n", field->path, text);
+        return false;
+    }
+
+    char* end = NULL;
+    long result = strtol(text, &end, 10);
+
+    if (end == text || *end != '\0') {
+        printf("ERROR: Setting '%s' expects an int, got '%s'.\n", field->path, text);
+        return false;
+    }
+
+    // Out of range values snap to the nearest bound
+    if (result < field->min || result > field->max) {
+        long clamped = (result < field->min) ? field->min : field->max;
+        printf("WARNING: Setting '%s' is out of range [%d, %d], got '%ld', using '%ld'.\n", field->path, field->min, field->max, result, clamped);
+        result = clamped;
+    }
+
+    *value = (int32_t) result;
+    return true;
+}
+
+// Warn about keys the schema doesn't know, mostly typos
+static void engine_settings_check_unknown(const ParserDocument* document, const ParserNode* node, char* path, uint32_t len) {
+
+    for (uint32_t child = node->first_child; child != PARSER_NODE_NONE; child = document->nodes[child].next_sibling) {
+        const ParserNode* child_node = &document->nodes[child];
+        if (!child_node->key) {
+            continue;
+        }
+
+        uint32_t child_len = len + (len ? 1 : 0) + child_node->key_len;
+        if (child_len >= 256) {
+            continue;
+        }
+
+        sprintf(path + len, (len) ? ".%s" : "%s", child_node->key);
+
+        if (child_node->type == PARSER_NODE_MAPPING) {
+            engine_settings_check_unknown(document, child_node, path, child_len);
+            continue;
+        }
+
+        bool known = false;
+        for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i) {
+            if (strcmp(schema_[i].path, path) == STR_EQUAL) {
+                known = true;
+                break;
+            }
+        }
+
+        if (!known) {
+            printf("WARNING: Unknown setting '%s' is ignored.\n", path);
+        }
+    }
+
+    path[len] = '\0';
+}
+
+// Load
+bool engine_settings_load(const char* path) {
+
+    // Parse into a copy, a reload only replaces the live settings once the file parsed
+    EngineSettings settings = settings_;
+
+    // Defaults on the first load, so every field is valid even if the file isn't
+    if (!loaded_) {
+        for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i) {
+            engine_settings_write(&settings, &schema_[i], schema_[i].fallback);
+        }
+    }
+
+    ParserDocument* document = parser_parse_yaml(path);
+    if (!document) {
+        if (loaded_) {
+            printf("ERROR: Failed to parse settings from file '%s', keeping the current settings.\n", path);
+            return false;
+        }
+
+        printf("ERROR: Failed to parse settings from file '%s', using the defaults.\n", path);
+
+        settings.version++;
+        settings_ = settings;
+        loaded_ = true;
+
+        return false;
+    }
+
+    uint32_t errors = 0;
+
+    for (uint32_t i = 0; i < SETTINGS_FIELD_COUNT; ++i) {
+        const SettingsField* field = &schema_[i];
+
+        const ParserNode* node = parser_document_find(document, field->path);
+        if (!node) {
+            continue;
+        }
+
+        int32_t value;
+        if (node->type != PARSER_NODE_SCALAR) {
+            printf("ERROR: Setting '%s' doesn't have a value.\n", field->path);
+            errors++;
+        } else if (engine_settings_parse(field, node->value, &value)) {
+            engine_settings_write(&settings, field, value);
+        } else {
+            errors++;
+        }
+    }
+
+    char key_path[256] = {0};
+    engine_settings_check_unknown(document, &document->nodes[0], key_path, 0);
+
+    parser_document_free(document);
+
+    if (errors) {
+        printf(
+            "ERROR: '%u' invalid settings in '%s' %s.\n", errors, path, 
+            (loaded_) ? "keep their current values" : "are set to their defaults"
+        );
+    }
+
+    settings.version++;
+    settings_ = settings;
+    loaded_ = true;
+
+    return errors == 0;
+}
+
+// Get
+const EngineSettings* engine_settings_get() {
+    return &settings_;
+}
\ No newline at end of file
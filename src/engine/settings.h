@@ -0,0 +1,49 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Defines
+#define SETTINGS_DEFAULT_PATH   "config.yaml"
+
+// Setting types
+#define SETTINGS_TYPE_INT       0
+#define SETTINGS_TYPE_BOOL      1
+
+// Settings, filled from the config file on startup and on every reload
+typedef struct EngineSettings {
+
+    // Window
+    int32_t window_width;
+    int32_t window_height;
+    bool vsync;
+    int32_t fps_limit; // 0 is uncapped
+    bool idle_render; // Sleep until input or a redraw request instead of drawing every frame
+    bool retina;
+    bool maximize;
+    int32_t window_mode;
+    int32_t monitor;
+
+    // Level
+    int32_t level_size;
+    int32_t tile_size;
+
+    uint32_t version; // Incremented on every load that parsed
+} EngineSettings;
+
+// Schema entry, ints are clamped to [min, max]
+typedef struct SettingsField {
+    const char* path;
+    int32_t type;
+    size_t offset;
+
+    int32_t fallback;
+    int32_t min;
+    int32_t max;
+} SettingsField;
+
+// Load, missing or invalid fields keep their defaults on the first load and their current values after that
+bool engine_settings_load(const char* path);
+
+// Get
+const EngineSettings* engine_settings_get();
\ No newline at end of file
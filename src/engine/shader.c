@@ -1,20 +1,41 @@
 #include "shader.h"
 
+#include "watch.h"
+#include "renderer.h"
+
 #include "util/util.h"
+#include "util/file.h"
+#include "util/arena.h"
+
+
+// Defines
+#define SHADER_MAX_PROGRAMS 32
 
+// Programs are swapped in place on reload, handles stay valid
+typedef struct ShaderProgram {
+    uint32_t program;
+
+    char* vertex_path;
+    char* fragment_path;
+    int32_t watches[2];
+} ShaderProgram;
 
 // Shared
 static Shader bound_shader_ = 0;
 
+static ShaderProgram programs_[SHADER_MAX_PROGRAMS]; // Handle 0 is never used
+
 // Static
-static uint32_t engine_shader_compile(uint32_t type, const char* shader_source) {
+static uint32_t engine_shader_compile(uint32_t type, const char* path) {
 
-	if (shader_source == NULL)
+    FileView source;
+	if (!file_load(&source, path, FILE_LOAD_READ))
 		return 0;
 
     uint32_t shader = glCreateShader(type);
-    const char* src = shader_source;
-    glShaderSource(shader, 1, &src, NULL);
+    const char* src = source.data;
+    int32_t len = (int32_t) source.size;
+    glShaderSource(shader, 1, &src, &len);
     glCompileShader(shader);
 
     int result;
@@ -24,7 +45,11 @@ static uint32_t engine_shader_compile(uint32_t type, const char* shader_source)
         int length;
         glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
 
-        char* message = (char*) malloc(length * sizeof(char));
+        Arena* scratch = arena_scratch();
+        ArenaMark mark = arena_mark(scratch);
+
+        char* message = ARENA_ALLOC(scratch, char, length + 1);
+        message[0] = '\0';
         glGetShaderInfoLog(shader, length, &length, message);
 		
 		char* shader_type = (type == GL_VERTEX_SHADER) ? "Vertex" : "Fragment";
@@ -34,27 +59,30 @@ static uint32_t engine_shader_compile(uint32_t type, const char* shader_source)
         // Cleanup
         glDeleteShader(shader);
 
-        free((void*) shader_source);
-        free(message);
+        file_release(&source);
+        arena_restore(scratch, mark);
 
         return 0;
     }
 
     // Cleanup
-    free((void*) shader_source);
+    file_release(&source);
 
     return shader;
 }
 
-// Shader creation & termination
-uint32_t engine_shader_new(const char* vertex_source, const char* fragment_source) {
+static uint32_t engine_shader_link(const char* vertex_source, const char* fragment_source) {
 
-    uint32_t program = glCreateProgram();
-    uint32_t vs = engine_shader_compile(GL_VERTEX_SHADER, read_file(vertex_source));
-    uint32_t fs = engine_shader_compile(GL_FRAGMENT_SHADER, read_file(fragment_source));
+    uint32_t vs = engine_shader_compile(GL_VERTEX_SHADER, vertex_source);
+    uint32_t fs = engine_shader_compile(GL_FRAGMENT_SHADER, fragment_source);
 
-	if (!(vs) || !(fs)) 
+	if (!(vs) || !(fs)) {
+        glDeleteShader(vs);
+        glDeleteShader(fs);
 		return 0;
+    }
+
+    uint32_t program = glCreateProgram();
 
     glAttachShader(program, vs);
     glAttachShader(program, fs);
@@ -86,13 +114,90 @@ uint32_t engine_shader_new(const char* vertex_source, const char* fragment_sourc
     return program;
 }
 
+static char* engine_shader_copy_path(const char* path) {
+    char* copy = (char*) calloc(strlen(path) + 1, sizeof(char));
+    return strcpy(copy, path);
+}
+
+static void engine_shader_reload(const char* path, void* user) {
+    Shader shader = (Shader) (uintptr_t) user;
+    ShaderProgram* program = &programs_[shader];
+
+    // Keep the old program running if the new one doesn't build
+    uint32_t id = engine_shader_link(program->vertex_path, program->fragment_path);
+    if (!id) {
+        printf("WARNING: Shader '%s' failed to reload, keeping the previous program.\n", path);
+        return;
+    }
+
+    glDeleteProgram(program->program);
+    program->program = id;
+
+    if (bound_shader_ == shader) {
+        glUseProgram(id);
+    }
+}
+
+static uint32_t engine_shader_program(Shader shader) {
+    return programs_[shader].program;
+}
+
+// Shader creation & termination
+Shader engine_shader_new(const char* vertex_source, const char* fragment_source) {
+
+    Shader shader = 0;
+    for (Shader i = 1; i < SHADER_MAX_PROGRAMS; ++i) {
+        if (!programs_[i].program) {
+            shader = i;
+            break;
+        }
+    }
+
+    if (!shader) {
+        printf("ERROR: Can't create more than '%d' shader programs.\n", SHADER_MAX_PROGRAMS - 1);
+        return 0;
+    }
+
+    uint32_t program = engine_shader_link(vertex_source, fragment_source);
+    if (!program) {
+        return 0;
+    }
+
+    programs_[shader] = (ShaderProgram) {
+        .program = program,
+
+        .vertex_path = engine_shader_copy_path(vertex_source),
+        .fragment_path = engine_shader_copy_path(fragment_source),
+    };
+
+    // Hot reload
+    programs_[shader].watches[0] = engine_watch_add(vertex_source, engine_shader_reload, (void*) (uintptr_t) shader);
+    programs_[shader].watches[1] = engine_watch_add(fragment_source, engine_shader_reload, (void*) (uintptr_t) shader);
+
+    return shader;
+}
+
 void engine_shader_free(Shader shader) {
-    glDeleteProgram(shader);
+    ShaderProgram* program = &programs_[shader];
+    if (!shader || !program->program) {
+        return;
+    }
+
+    engine_watch_remove(program->watches[0]);
+    engine_watch_remove(program->watches[1]);
+
+    glDeleteProgram(program->program);
+
+    free(program->vertex_path);
+    free(program->fragment_path);
+
+    *program = (ShaderProgram) {0};
 }
 
 // Shader
 void engine_shader_bind(Shader shader) {
-    glUseProgram(shader);
+    glUseProgram(engine_shader_program(shader));
+    RENDER_COUNT(program_binds, 1);
     bound_shader_ = shader;
 }
 
@@ -108,7 +213,7 @@ Shader engine_bound_shader() {
 
 // Uniforms
 void engine_shader_int(Shader shader, const char* location, int32_t value) {
-    int32_t loc = glGetUniformLocation(shader, location);
+    int32_t loc = glGetUniformLocation(engine_shader_program(shader), location);
 
 #ifdef DEBUG
     if (loc == -1) {
@@ -118,10 +223,11 @@ void engine_shader_int(Shader shader, const char* location, int32_t value) {
 #endif
 
     glUniform1i(loc, value);
+    RENDER_COUNT(uniform_uploads, 1);
 }
 
 void engine_shader_float(Shader shader, const char* location, float value) {
-    int32_t loc = glGetUniformLocation(shader, location);
+    int32_t loc = glGetUniformLocation(engine_shader_program(shader), location);
 
 #ifdef DEBUG
     if (loc == -1) {
@@ -131,10 +237,11 @@ void engine_shader_float(Shader shader, const char* location, float value) {
 #endif
 
     glUniform1f(loc, value);
+    RENDER_COUNT(uniform_uploads, 1);
 }
 
 void engine_shader_vec2(Shader shader, const char* location, vec2 vec2) {
-    int32_t loc = glGetUniformLocation(shader, location);
+    int32_t loc = glGetUniformLocation(engine_shader_program(shader), location);
 
 #ifdef DEBUG
     if (loc == -1) {
@@ -144,10 +251,11 @@ void engine_shader_vec2(Shader shader, const char* location, vec2 vec2) {
 #endif
 
     glUniform2f(loc, vec2[0], vec2[1]);
+    RENDER_COUNT(uniform_uploads, 1);
 }
 
 void engine_shader_vec3(Shader shader, const char* location, vec3 vec3) {
-    int32_t loc = glGetUniformLocation(shader, location);
+    int32_t loc = glGetUniformLocation(engine_shader_program(shader), location);
 
 #ifdef DEBUG
     if (loc == -1) {
@@ -157,10 +265,11 @@ void engine_shader_vec3(Shader shader, const char* location, vec3 vec3) {
 #endif
 
     glUniform3f(loc, vec3[0], vec3[1], vec3[2]);
+    RENDER_COUNT(uniform_uploads, 1);
 }
 
 void engine_shader_vec4(Shader shader, const char* location, vec4 vec4) {
-    int32_t loc = glGetUniformLocation(shader, location);
+    int32_t loc = glGetUniformLocation(engine_shader_program(shader), location);
 
 #ifdef DEBUG
     if (loc == -1) {
@@ -170,10 +279,11 @@ void engine_shader_vec4(Shader shader, const char* location, vec4 vec4) {
 #endif
 
     glUniform4f(loc, vec4[0], vec4[1], vec4[2], vec4[3]);
+    RENDER_COUNT(uniform_uploads, 1);
 }
 
 void engine_shader_mat4(Shader shader, const char* location, mat4 mat4) {
-    int32_t loc = glGetUniformLocation(shader, location);
+    int32_t loc = glGetUniformLocation(engine_shader_program(shader), location);
 
 #ifdef DEBUG
     if (loc == -1) {
@@ -183,4 +293,5 @@ void engine_shader_mat4(Shader shader, const char* location, mat4 mat4) {
 #endif
 
     glUniformMatrix4fv(loc, 1, GL_FALSE, mat4[0]);
+    RENDER_COUNT(uniform_uploads, 1);
 }
\ No newline at end of file
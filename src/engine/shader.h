@@ -4,7 +4,7 @@
 
 
 // Types
-typedef uint32_t Shader;
+typedef uint32_t Shader; // Handle into the program table, 0 is no shader
 
 // Shader creation & termination
 Shader engine_shader_new(const char* vertex_source, const char* fragment_source);
@@ -1,7 +1,162 @@
+#define HEAP_TAG HEAP_TAG_TEXTURE
 #include "texture.h"
 
+#include "engine.h"
+#include "watch.h"
+#include "trace.h"
+#include "renderer.h"
+
+#include "util/file.h"
+
 #include <stb_image/stb_image.h>
 
+#include <pthread.h>
+
+
+// Defines
+#define TEXTURE_MAX_RELOADS 16
+
+// Image decoded on a worker thread, uploaded by the main thread on the next update
+typedef struct TextureReload {
+    Texture* texture;
+    pthread_t thread;
+
+    uint8_t* pixels;
+    int32_t width;
+    int32_t height;
+    int32_t bpp;
+
+    uint32_t done; // Atomic
+    bool again; // Changed again while decoding
+} TextureReload;
+
+// Reloads, heap allocated so workers keep a stable pointer
+static TextureReload* reloads_[TEXTURE_MAX_RELOADS];
+static uint32_t reload_count_;
+
+// Static
+static int64_t engine_texture_image_bytes(int32_t width, int32_t height) {
+    return (int64_t) width * height * 4;
+}
+
+static void engine_texture_upload(Texture* t, const uint8_t* pixels) {
+
+    glBindTexture(GL_TEXTURE_2D, t->id);
+
+    uint32_t mipmap_filter = (t->filter == GL_LINEAR) ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
+    
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmap_filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, t->filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, t->width, t->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    RENDER_COUNT(buffer_uploads, 1);
+
+    glBindTexture(GL_TEXTURE_2D, 0);    
+
+    // The mip chain adds about a third
+    heap_track_gpu(-t->gpu_bytes);
+    t->gpu_bytes = engine_texture_image_bytes(t->width, t->height) * 4 / 3;
+    heap_track_gpu(t->gpu_bytes);
+}
+
+static void* engine_texture_decode(void* data) {
+    TextureReload* reload = (TextureReload*) data;
+
+    engine_trace_thread_name("texture_decode");
+    engine_trace_begin("decode_texture");
+
+    stbi_set_flip_vertically_on_load_thread(true);
+
+    FileView file;
+    if (file_load(&file, reload->texture->path, FILE_LOAD_AUTO)) {
+        reload->pixels = stbi_load_from_memory(
+            (const stbi_uc*) file.data, (int) file.size, 
+            &reload->width, &reload->height, &reload->bpp, 4
+        );
+        file_release(&file);
+
+        if (reload->pixels) {
+            heap_track(HEAP_TAG_TEXTURE, engine_texture_image_bytes(reload->width, reload->height));
+        }
+    }
+
+    engine_trace_end("decode_texture");
+
+    __atomic_store_n(&reload->done, 1, __ATOMIC_RELEASE);
+
+    // Wake an idle main thread so the new image gets swapped in
+    engine_request_redraw();
+
+    return NULL;
+}
+
+static void engine_texture_start_reload(Texture* texture) {
+
+    // Already decoding, pick up the newer file once it's done
+    for (uint32_t i = 0; i < reload_count_; ++i) {
+        if (reloads_[i]->texture == texture) {
+            reloads_[i]->again = true;
+            return;
+        }
+    }
+
+    if (reload_count_ == TEXTURE_MAX_RELOADS) {
+        printf("WARNING: Too many textures reloading, skipping '%s'.\n", texture->path);
+        return;
+    }
+
+    TextureReload* reload = (TextureReload*) calloc(1, sizeof(TextureReload));
+    reload->texture = texture;
+
+    if (pthread_create(&reload->thread, NULL, engine_texture_decode, reload) != 0) {
+        printf("ERROR: Failed to start reloading '%s'.\n", texture->path);
+        free(reload);
+        return;
+    }
+
+    reloads_[reload_count_++] = reload;
+}
+
+static void engine_texture_finish_reload(uint32_t index, bool upload) {
+    TextureReload* reload = reloads_[index];
+    Texture* texture = reload->texture;
+
+    pthread_join(reload->thread, NULL);
+
+    bool again = reload->again;
+
+    if (reload->pixels && upload) {
+        texture->width = reload->width;
+        texture->height = reload->height;
+        texture->bpp = reload->bpp;
+
+        engine_texture_upload(texture, reload->pixels);
+        texture->version++;
+    } else if (upload) {
+        printf("ERROR : Image file \"%s\" could not be reloaded, keeping the previous image.\n", texture->path);
+    }
+
+    if (reload->pixels) {
+        heap_track(HEAP_TAG_TEXTURE, -engine_texture_image_bytes(reload->width, reload->height));
+    }
+
+    stbi_image_free(reload->pixels);
+    free(reload);
+
+    // Swap remove, order doesn't matter
+    reloads_[index] = reloads_[--reload_count_];
+
+    if (again && upload) {
+        engine_texture_start_reload(texture);
+    }
+}
+
+static void engine_texture_on_change(const char* path, void* user) {
+    engine_texture_start_reload((Texture*) user);
+}
 
 // Teture creation & termination
 Texture* engine_texture_new(const char* path, uint32_t filter) {
@@ -10,8 +165,16 @@ Texture* engine_texture_new(const char* path, uint32_t filter) {
     Texture* t = (Texture*) malloc(sizeof(Texture));
     
     // Load the imade
+    FileView file;
+    if (!file_load(&file, path, FILE_LOAD_AUTO)) {
+        free(t);
+        return NULL;
+    }
+
     stbi_set_flip_vertically_on_load(true);
-	uint8_t* local_buffer = stbi_load(path, &t->width, &t->height, &t->bpp, 4);
+	uint8_t* local_buffer = stbi_load_from_memory((const stbi_uc*) file.data, (int) file.size, &t->width, &t->height, &t->bpp, 4);
+
+    file_release(&file);
 
     if (!local_buffer) {
         printf("ERROR : Image file \"%s\" could not be read.\n", path);
@@ -20,29 +183,44 @@ Texture* engine_texture_new(const char* path, uint32_t filter) {
         return NULL;
     }
 
-    glGenTextures(1, &t->id);
-    glBindTexture(GL_TEXTURE_2D, t->id);
+    // Decoded by stb_image, counted by hand
+    heap_track(HEAP_TAG_TEXTURE, engine_texture_image_bytes(t->width, t->height));
 
-    uint32_t mipmap_filter = (filter == GL_LINEAR) ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_NEAREST;
-    
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmap_filter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, t->width, t->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, local_buffer);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    t->path = (char*) calloc(strlen(path) + 1, sizeof(char));
+    strcpy(t->path, path);
 
-    glBindTexture(GL_TEXTURE_2D, 0);    
+    t->filter = filter;
+    t->version = 0;
+    t->gpu_bytes = 0;
+
+    glGenTextures(1, &t->id);
+    engine_texture_upload(t, local_buffer);
+
+    heap_track(HEAP_TAG_TEXTURE, -engine_texture_image_bytes(t->width, t->height));
     stbi_image_free(local_buffer);
+
+    // Hot reload
+    t->watch = engine_watch_add(path, engine_texture_on_change, t);
     
 	return t;
 }
 
 void engine_texture_free(Texture* texture) {
 
+    // Drop any reload still in flight
+    for (uint32_t i = 0; i < reload_count_; ++i) {
+        if (reloads_[i]->texture == texture) {
+            engine_texture_finish_reload(i, false);
+            break;
+        }
+    }
+
+    engine_watch_remove(texture->watch);
+
     glDeleteTextures(1, &texture->id);
+    heap_track_gpu(-texture->gpu_bytes);
     
+    free(texture->path);
     free(texture);
 }
 
@@ -50,8 +228,23 @@ void engine_texture_free(Texture* texture) {
 void engine_texture_bind(Texture* texture, uint32_t slot) {
     glActiveTexture(GL_TEXTURE0 + slot);
     glBindTexture(GL_TEXTURE_2D, texture->id);
+    RENDER_COUNT(texture_binds, 1);
 }
 
 void engine_texture_unbind(Texture* texture) {
     glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+// Reload
+void engine_texture_update() {
+
+    // Same GL id, so every holder of the texture sees the new image
+    for (uint32_t i = 0; i < reload_count_; ) {
+        if (__atomic_load_n(&reloads_[i]->done, __ATOMIC_ACQUIRE)) {
+            engine_texture_finish_reload(i, true);
+            engine_request_redraw();
+        } else {
+            ++i;
+        }
+    }
 }
\ No newline at end of file
@@ -9,6 +9,13 @@ typedef struct Texture {
     int32_t bpp;
     int32_t width;
     int32_t height;
+    int64_t gpu_bytes; // Estimated, including the mipmaps
+
+    // Hot reload
+    char* path;
+    uint32_t filter;
+    int32_t watch;
+    uint32_t version; // Incremented when the image is replaced
 } Texture;
 
 // Teture creation & termination
@@ -19,4 +26,7 @@ void engine_texture_free(Texture* texture);
 // Texture
 void engine_texture_bind(Texture* texture, uint32_t slot);
 
-void engine_texture_unbind(Texture* texture);
\ No newline at end of file
+void engine_texture_unbind(Texture* texture);
+
+// Reload, uploads the images decoded in the background
+void engine_texture_update();
\ No newline at end of file
@@ -0,0 +1,349 @@
+#include "trace.h"
+
+#include "util/vector.h"
+
+#include <pthread.h>
+
+
+// Defines
+#define TRACE_RING_MASK     (TRACE_RING_SIZE - 1)
+#define TRACE_GPU_TID       0
+
+// Event, written as a Chrome trace event
+typedef struct TraceEvent {
+    const char* name;
+    double timestamp;
+    double duration;
+    uint32_t tid;
+    char phase;
+} TraceEvent;
+
+VECTOR_DECLARE(TraceEvent, 0);
+
+// Single producer single consumer ring, the owning thread writes and the main thread drains
+typedef struct TraceRing {
+    TraceEvent events[TRACE_RING_SIZE];
+    uint32_t head; // Atomic, written by the owner
+    uint32_t tail; // Atomic, written by the main thread
+    uint32_t dropped; // Atomic
+
+    uint32_t owned; // Atomic, rings of finished threads are taken over by new ones
+    struct TraceRing* next;
+} TraceRing;
+
+// Rings, only ever added to until terminate
+static TraceRing* rings_;
+static pthread_key_t ring_key_;
+static bool ring_key_ready_;
+
+static __thread TraceRing* ring_;
+static __thread uint32_t tid_;
+
+static uint32_t next_tid_ = TRACE_GPU_TID + 1;
+static const char* thread_names_[TRACE_MAX_THREADS];
+
+// Recording
+static uint32_t recording_; // Atomic
+static uint32_t frames_left_;
+static char* path_;
+static VECTOR(TraceEvent) events_;
+
+// Static
+static void engine_trace_release_ring(void* data) {
+    __atomic_store_n(&((TraceRing*) data)->owned, 0, __ATOMIC_RELEASE);
+}
+
+static uint32_t engine_trace_tid() {
+    if (!tid_) {
+        tid_ = __atomic_fetch_add(&next_tid_, 1, __ATOMIC_RELAXED);
+    }
+
+    return tid_;
+}
+
+static TraceRing* engine_trace_ring() {
+    if (ring_) {
+        return ring_;
+    }
+
+    // Take over the ring of a finished thread
+    TraceRing* ring = __atomic_load_n(&rings_, __ATOMIC_ACQUIRE);
+    for (; ring; ring = ring->next) {
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&ring->owned, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+
+    // Or add a new one to the list
+    if (!ring) {
+        ring = (TraceRing*) calloc(1, sizeof(TraceRing));
+        ring->owned = 1;
+
+        ring->next = __atomic_load_n(&rings_, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&rings_, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        }
+    }
+
+    // Hand it back when the thread exits
+    if (ring_key_ready_) {
+        pthread_setspecific(ring_key_, ring);
+    }
+
+    ring_ = ring;
+    return ring;
+}
+
+static void engine_trace_push(TraceEvent event) {
+    TraceRing* ring = engine_trace_ring();
+
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+    if (head - tail == TRACE_RING_SIZE) {
+        __atomic_fetch_add(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    ring->events[head & TRACE_RING_MASK] = event;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+static void engine_trace_drain(bool keep) {
+    for (TraceRing* ring = __atomic_load_n(&rings_, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+
+        uint32_t tail = ring->tail;
+        uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+        if (keep) {
+            VECTOR_RESERVE(&events_, events_.count + (head - tail));
+            for (; tail != head; ++tail) {
+                events_.array[events_.count++] = ring->events[tail & TRACE_RING_MASK];
+            }
+        }
+
+        __atomic_store_n(&ring->tail, head, __ATOMIC_RELEASE);
+    }
+}
+
+static void engine_trace_write_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+static bool engine_trace_write(const char* path) {
+
+    FILE* file;
+    if (!(file = fopen(path, "w"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        return false;
+    }
+
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    // Track names
+    fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"gpu\"}}", TRACE_GPU_TID);
+
+    uint32_t thread_count = __atomic_load_n(&next_tid_, __ATOMIC_RELAXED);
+    for (uint32_t tid = TRACE_GPU_TID + 1; tid < thread_count && tid < TRACE_MAX_THREADS; ++tid) {
+        const char* name = __atomic_load_n(&thread_names_[tid], __ATOMIC_RELAXED);
+        if (!name) {
+            continue;
+        }
+
+        fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", tid);
+        engine_trace_write_string(file, name);
+        fprintf(file, "}}");
+    }
+
+    for (uint32_t i = 0; i < events_.count; ++i) {
+        const TraceEvent* event = &events_.array[i];
+
+        fprintf(file, ",\n{\"name\":");
+        engine_trace_write_string(file, event->name);
+        fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%u", event->phase, event->timestamp, event->tid);
+
+        if (event->phase == 'X') {
+            fprintf(file, ",\"dur\":%.3f", event->duration);
+        }
+
+        fprintf(file, "}");
+    }
+
+    fprintf(file, "\n]}\n");
+
+    if (fclose(file) != 0) {
+        printf("ERROR: Failed to write '%s'.\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+// Init
+void engine_trace_init() {
+    ring_key_ready_ = (pthread_key_create(&ring_key_, engine_trace_release_ring) == 0);
+
+    engine_trace_thread_name("main");
+}
+
+void engine_trace_terminate() {
+    if (engine_trace_recording()) {
+        engine_trace_stop();
+    }
+
+    if (ring_key_ready_) {
+        pthread_key_delete(ring_key_);
+        ring_key_ready_ = false;
+    }
+
+    // Every other thread has been joined by now
+    TraceRing* ring = rings_;
+    while (ring) {
+        TraceRing* next = ring->next;
+        free(ring);
+        ring = next;
+    }
+
+    rings_ = NULL;
+    ring_ = NULL;
+}
+
+// Recording
+bool engine_trace_start(const char* path, uint32_t frames) {
+    if (engine_trace_recording()) {
+        printf("WARNING: A trace is already being recorded.\n");
+        return false;
+    }
+
+    // Whatever was left in the rings belongs to an older recording
+    engine_trace_drain(false);
+
+    path_ = (char*) calloc(strlen(path) + 1, sizeof(char));
+    strcpy(path_, path);
+
+    VECTOR_INIT(&events_, NULL);
+    VECTOR_RESERVE(&events_, TRACE_RING_SIZE);
+
+    frames_left_ = frames;
+    __atomic_store_n(&recording_, 1, __ATOMIC_RELEASE);
+
+    printf("INFO: Recording a trace to '%s'.\n", path);
+
+    return true;
+}
+
+void engine_trace_stop() {
+    if (!engine_trace_recording()) {
+        return;
+    }
+
+    __atomic_store_n(&recording_, 0, __ATOMIC_RELEASE);
+    engine_trace_drain(true);
+
+    uint32_t dropped = 0;
+    for (TraceRing* ring = __atomic_load_n(&rings_, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+        dropped += __atomic_exchange_n(&ring->dropped, 0, __ATOMIC_RELAXED);
+    }
+
+    if (engine_trace_write(path_)) {
+        printf("INFO: Trace with '%u' events written to '%s'.\n", events_.count, path_);
+    }
+    if (dropped) {
+        printf("WARNING: '%u' trace events were dropped, the rings were full.\n", dropped);
+    }
+
+    VECTOR_FREE(&events_);
+
+    free(path_);
+    path_ = NULL;
+}
+
+bool engine_trace_recording() {
+    return __atomic_load_n(&recording_, __ATOMIC_ACQUIRE);
+}
+
+// Frame
+void engine_trace_frame() {
+    if (!engine_trace_recording()) {
+        return;
+    }
+
+    engine_trace_drain(true);
+
+    if (frames_left_ && --frames_left_ == 0) {
+        engine_trace_stop();
+    }
+}
+
+// Events
+void engine_trace_thread_name(const char* name) {
+    uint32_t tid = engine_trace_tid();
+    if (tid < TRACE_MAX_THREADS) {
+        __atomic_store_n(&thread_names_[tid], name, __ATOMIC_RELAXED);
+    }
+}
+
+void engine_trace_begin(const char* name) {
+    if (!__atomic_load_n(&recording_, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    engine_trace_push((TraceEvent) {
+        .name = name,
+        .timestamp = engine_trace_now(),
+        .tid = engine_trace_tid(),
+        .phase = 'B',
+    });
+}
+
+void engine_trace_end(const char* name) {
+    if (!__atomic_load_n(&recording_, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    engine_trace_push((TraceEvent) {
+        .name = name,
+        .timestamp = engine_trace_now(),
+        .tid = engine_trace_tid(),
+        .phase = 'E',
+    });
+}
+
+void engine_trace_complete(const char* name, double start, double duration) {
+    if (!__atomic_load_n(&recording_, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    engine_trace_push((TraceEvent) {
+        .name = name,
+        .timestamp = start,
+        .duration = duration,
+        .tid = engine_trace_tid(),
+        .phase = 'X',
+    });
+}
+
+void engine_trace_gpu(const char* name, double start, double duration) {
+    if (!__atomic_load_n(&recording_, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    engine_trace_push((TraceEvent) {
+        .name = name,
+        .timestamp = start,
+        .duration = duration,
+        .tid = TRACE_GPU_TID,
+        .phase = 'X',
+    });
+}
+
+double engine_trace_now() {
+    return glfwGetTime() * 1e6;
+}
\ No newline at end of file
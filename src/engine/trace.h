@@ -0,0 +1,38 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Defines
+#define TRACE_DEFAULT_PATH      "trace.json"
+#define TRACE_DEFAULT_FRAMES    300
+#define TRACE_RING_SIZE         16384 // Events per thread between two frames, power of two
+#define TRACE_MAX_THREADS       64
+
+// Init
+void engine_trace_init();
+
+void engine_trace_terminate();
+
+// Recording, frames is 0 to record until engine_trace_stop
+bool engine_trace_start(const char* path, uint32_t frames);
+
+void engine_trace_stop();
+
+bool engine_trace_recording();
+
+// Frame, collects the events of every thread, called by the profiler
+void engine_trace_frame();
+
+// Events, from any thread, names must be string literals or otherwise outlive the recording
+void engine_trace_thread_name(const char* name);
+
+void engine_trace_begin(const char* name);
+
+void engine_trace_end(const char* name);
+
+void engine_trace_complete(const char* name, double start, double duration); // Microseconds
+
+void engine_trace_gpu(const char* name, double start, double duration); // On its own track
+
+double engine_trace_now(); // Microseconds
\ No newline at end of file
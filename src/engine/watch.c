@@ -0,0 +1,208 @@
+#include "watch.h"
+
+#include "engine.h"
+
+#include "util/util.h"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <limits.h>
+#include <errno.h>
+#endif
+
+
+// Defines
+#define WATCH_MAX_ENTRIES   64
+#define WATCH_EVENT_BUFFER  4096
+
+// Editors often save through a temporary file and a rename, so directories are watched
+typedef struct WatchEntry {
+    bool active;
+    bool changed;
+
+    int32_t wd;
+    char* path;
+    const char* name; // File name inside path
+
+    watch_func_t func;
+    void* user;
+} WatchEntry;
+
+// Watches
+static int32_t fd_ = -1;
+static WatchEntry entries_[WATCH_MAX_ENTRIES];
+
+// Init
+bool engine_watch_init() {
+#ifdef __linux__
+    fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd_ < 0) {
+        printf("ERROR: File watcher failed to initialize, hot reload is disabled.\n");
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+void engine_watch_terminate() {
+
+    for (int32_t i = 0; i < WATCH_MAX_ENTRIES; ++i) {
+        if (entries_[i].active) {
+            engine_watch_remove(i);
+        }
+    }
+
+#ifdef __linux__
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+// Watch
+int32_t engine_watch_add(const char* path, watch_func_t func, void* user) {
+#ifdef __linux__
+    if (fd_ < 0) {
+        return -1;
+    }
+
+    int32_t id = -1;
+    for (int32_t i = 0; i < WATCH_MAX_ENTRIES; ++i) {
+        if (!entries_[i].active) {
+            id = i;
+            break;
+        }
+    }
+
+    if (id < 0) {
+        printf("ERROR: Can't watch more than '%d' files, '%s' won't be hot reloaded.\n", WATCH_MAX_ENTRIES, path);
+        return -1;
+    }
+
+    // Split the directory from the file name
+    char* copy = (char*) calloc(strlen(path) + 1, sizeof(char));
+    strcpy(copy, path);
+
+    const char* slash = strrchr(copy, '/');
+    const char* name = (slash) ? slash + 1 : copy;
+
+    char directory[PATH_MAX];
+    if (slash) {
+        snprintf(directory, sizeof(directory), "%.*s", (int) (slash - copy), copy);
+    } else {
+        strcpy(directory, ".");
+    }
+
+    // Adding the same directory again returns the same descriptor
+    int32_t wd = inotify_add_watch(fd_, directory, IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (wd < 0) {
+        // Served from the resource pack, nothing to watch
+        if (errno != ENOENT) {
+            printf("ERROR: Failed to watch '%s'.\n", path);
+        }
+        free(copy);
+        return -1;
+    }
+
+    entries_[id] = (WatchEntry) {
+        .active = true,
+        .changed = false,
+
+        .wd = wd,
+        .path = copy,
+        .name = name,
+
+        .func = func,
+        .user = user,
+    };
+
+    return id;
+#else
+    return -1;
+#endif
+}
+
+void engine_watch_remove(int32_t id) {
+    if (id < 0 || id >= WATCH_MAX_ENTRIES || !entries_[id].active) {
+        return;
+    }
+
+    WatchEntry* entry = &entries_[id];
+    entry->active = false;
+
+#ifdef __linux__
+    // Keep the directory watch while other files in it are watched
+    bool shared = false;
+    for (int32_t i = 0; i < WATCH_MAX_ENTRIES; ++i) {
+        if (entries_[i].active && entries_[i].wd == entry->wd) {
+            shared = true;
+            break;
+        }
+    }
+
+    if (!shared && fd_ >= 0) {
+        inotify_rm_watch(fd_, entry->wd);
+    }
+#endif
+
+    free(entry->path);
+    entry->path = NULL;
+}
+
+// Events
+void engine_watch_poll() {
+#ifdef __linux__
+    if (fd_ < 0) {
+        return;
+    }
+
+    // Drain the queue without blocking, several writes to a file are merged into one change
+    char buffer[WATCH_EVENT_BUFFER] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool any = false;
+
+    for (;;) {
+        ssize_t len = read(fd_, buffer, sizeof(buffer));
+        if (len <= 0) {
+            break;
+        }
+
+        for (char* c = buffer; c < buffer + len; ) {
+            const struct inotify_event* event = (const struct inotify_event*) c;
+            c += sizeof(struct inotify_event) + event->len;
+
+            if (!event->len) {
+                continue;
+            }
+
+            for (int32_t i = 0; i < WATCH_MAX_ENTRIES; ++i) {
+                WatchEntry* entry = &entries_[i];
+
+                if (entry->active && entry->wd == event->wd && strcmp(entry->name, event->name) == STR_EQUAL) {
+                    entry->changed = true;
+                    any = true;
+                }
+            }
+        }
+    }
+
+    if (!any) {
+        return;
+    }
+
+    for (int32_t i = 0; i < WATCH_MAX_ENTRIES; ++i) {
+        WatchEntry* entry = &entries_[i];
+
+        if (entry->active && entry->changed) {
+            entry->changed = false;
+
+            printf("INFO: '%s' changed, reloading.\n", entry->path);
+            entry->func(entry->path, entry->user);
+
+            engine_request_redraw();
+        }
+    }
+#endif
+}
\ No newline at end of file
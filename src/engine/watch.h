@@ -0,0 +1,20 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Called once per poll for every changed file
+typedef void (*watch_func_t)(const char* path, void* user);
+
+// Init
+bool engine_watch_init();
+
+void engine_watch_terminate();
+
+// Watch
+int32_t engine_watch_add(const char* path, watch_func_t func, void* user);
+
+void engine_watch_remove(int32_t id);
+
+// Events
+void engine_watch_poll();
\ No newline at end of file
@@ -1,11 +1,10 @@
 #include "window.h"
 
-#include "parser/parser.h"
-
-#include "util/map.h"
 #include "util/util.h"
 
 #include "input.h"
+#include "settings.h"
+#include "engine.h"
 
 
 // Engine properties
@@ -14,74 +13,94 @@ static GLFWmonitor* monitor_ = NULL;
 static GLFWmonitor** available_monitors_ = NULL;
 static int32_t monitor_count_ = 0;
 
-static const char* config_path_ = "config.yaml";
-
-// Window defaults
-static const uint32_t SCREEN_WIDTH = 800;
-static const uint32_t SCREEN_HEIGHT = 600;
-static const bool VSYNC = true;
-static const bool RETINA = false;
-static const bool MAXIMIZE = false;
-static const int32_t WINDOW_MODE = WINDOW_MODE_WINDOWED;
-static const uint32_t MONITOR_INDEX = 0;
-
-// Window properties
+// Window properties, defaults come from the settings schema
 static const char* title_ = "CTiled";
-static uint32_t window_width_ = SCREEN_WIDTH;
-static uint32_t window_height_ = SCREEN_HEIGHT;
-static bool vsync_ = VSYNC;
-static bool retina_ = RETINA;
-static bool maximize_ = MAXIMIZE;
-static int32_t window_mode_ = WINDOW_MODE;
-static uint32_t monitor_index_ = MONITOR_INDEX;
+static uint32_t window_width_;
+static uint32_t window_height_;
+static bool vsync_;
+static bool retina_;
+static bool maximize_;
+static int32_t window_mode_;
+static uint32_t monitor_index_;
+
+// Headless, hidden window rendering into an offscreen framebuffer
+static bool headless_;
+static GLuint framebuffer_;
+static GLuint color_buffer_;
+static GLuint depth_buffer_;
+static int64_t framebuffer_bytes_;
 
 // Static
-static void engine_window_parse_properties() {
-    Map* properties = parser_parse_yaml(config_path_);
-    if (!properties) {
-        printf("ERROR: Failed to parse properties from file '%s'.\n", config_path_);
-        return;
-    }
+static void engine_window_refresh_callback(GLFWwindow* window) {
 
-    // Width
-    int width = parser_yaml_parse_int(properties, "width");
-    if (width != 0) {
-        window_width_ = width;
-    }
+    // Uncovered or resized, an idle engine has to draw the contents again
+    engine_request_redraw();
+}
 
-    // Height
-    int height = parser_yaml_parse_int(properties, "height");
-    if (height != 0) {
-        window_height_ = height;
-    }
+static void engine_window_apply_settings() {
+    const EngineSettings* settings = engine_settings_get();
 
-    // Vsync
-    vsync_ = parser_yaml_parse_bool(properties, "vsync");
+    window_width_  = settings->window_width;
+    window_height_ = settings->window_height;
+    vsync_         = settings->vsync;
+    retina_        = settings->retina;
+    maximize_      = settings->maximize;
+    window_mode_   = settings->window_mode;
+    monitor_index_ = settings->monitor;
+}
 
-    // Retina
-    retina_ = parser_yaml_parse_bool(properties, "retina");
+static bool engine_window_create_framebuffer() {
 
-    // Maximize
-    maximize_ = parser_yaml_parse_bool(properties, "maximize");
+    vec2s size = engine_window_get_pixel_size();
 
-    // Window mode 
-    int window_mode = parser_yaml_parse_int(properties, "window-mode");
-    if (window_mode >= 0 && window_mode <= 2) {
-        window_mode_ = window_mode;
-    }
+    glGenRenderbuffers(1, &color_buffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, color_buffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size.x, size.y);
+
+    glGenRenderbuffers(1, &depth_buffer_);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer_);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, size.x, size.y);
+
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
 
-    // Monitor index
-    int monitor_index = parser_yaml_parse_int(properties, "monitor");
-    if (monitor_index >= 0) {
-        monitor_index_ = monitor_index;
+    glGenFramebuffers(1, &framebuffer_);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color_buffer_);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth_buffer_);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        printf("ERROR: Offscreen framebuffer is incomplete.\n");
+        return false;
     }
 
-    map_free(properties);
-    free(properties);
+    // Stays bound, everything renders into it
+    framebuffer_bytes_ = (int64_t) size.x * size.y * 8;
+    heap_track_gpu(framebuffer_bytes_);
+
+    return true;
 }
 
 // Init
+void engine_window_set_headless(bool headless) {
+    headless_ = headless;
+}
+
 bool engine_init_window() {
+
+    // No display needed, the context comes from OSMesa. Anything else would still need an X server or a desktop
+    if (headless_) {
+#ifdef GLFW_PLATFORM_NULL
+        if (!glfwPlatformSupported(GLFW_PLATFORM_NULL)) {
+            printf("ERROR: Headless rendering needs GLFW built with the null platform.\n");
+            return false;
+        }
+
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+        printf("ERROR: Headless rendering needs GLFW 3.4 or newer, this build has %s.\n", glfwGetVersionString());
+        return false;
+#endif
+    }
     
     // Initialize GLFW
     if (!glfwInit()) {
@@ -100,36 +119,71 @@ bool engine_init_window() {
     // Window hints
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE); // Hardcoded disabled resizable window feature
 
-    // Parse window properties
-    engine_window_parse_properties();
+    if (headless_) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef GLFW_PLATFORM_NULL
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+    }
+
+    // Window properties
+    engine_window_apply_settings();
+
+    if (headless_) {
+        window_mode_ = WINDOW_MODE_WINDOWED;
+        vsync_ = false;
+    }
 
     // Create window
     window_ = glfwCreateWindow(window_width_, window_height_, title_, NULL, NULL);
     if (!(window_)) {
-        printf("ERROR: GLFW Window could not be created.\n");
+        if (headless_) {
+            printf("ERROR: Headless GL context could not be created, is OSMesa (libOSMesa) installed?\n");
+        } else {
+            printf("ERROR: GLFW Window could not be created.\n");
+        }
         glfwTerminate();
         return false;
     }
 
-    // Update monitors
-    engine_window_update_monitors();
+    // A hidden window has no monitor to be placed on
+    if (!headless_) {
 
-    // Set monitor
-    engine_window_set_monitor(monitor_index_);
+        // Update monitors
+        engine_window_update_monitors();
 
-    // Set the window mode
-    engine_window_set_mode(window_mode_);
+        // Set monitor
+        engine_window_set_monitor(monitor_index_);
+
+        // Set the window mode
+        engine_window_set_mode(window_mode_);
+    }
 
     // Make window context current
     glfwMakeContextCurrent(window_);
 
     // Initialize GLEW
-    if (glewInit() != 0) { // 0 means success
+    GLenum glew_result = glewInit();
+
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    // OSMesa contexts have no GLX display, the GL entry points are loaded regardless
+    if (headless_ && glew_result == GLEW_ERROR_NO_GLX_DISPLAY) {
+        glew_result = GLEW_OK;
+    }
+#endif
+
+    if (glew_result != 0) { // 0 means success
         printf("ERROR: GLEW failed to initialize.\n");
         glfwTerminate();
         return false;
     }
 
+    // Offscreen target
+    if (headless_ && !engine_window_create_framebuffer()) {
+        glfwTerminate();
+        return false;
+    }
+
     // Set VSync
     engine_window_set_vsync(vsync_);
 
@@ -145,11 +199,24 @@ bool engine_init_window() {
 
     glfwSetScrollCallback(window_, engine_input_scroll_input_callback);
 
+    glfwSetCursorPosCallback(window_, engine_input_cursor_pos_callback);
+
+    glfwSetWindowRefreshCallback(window_, engine_window_refresh_callback);
+
     return true;
 }
 
 void engine_terminate_window() {
 
+    if (framebuffer_) {
+        glDeleteFramebuffers(1, &framebuffer_);
+        glDeleteRenderbuffers(1, &color_buffer_);
+        glDeleteRenderbuffers(1, &depth_buffer_);
+        heap_track_gpu(-framebuffer_bytes_);
+
+        framebuffer_ = 0;
+    }
+
     glfwTerminate();
 }
 
@@ -163,6 +230,11 @@ void engine_window_update_monitors() {
 }
 
 void engine_window_set_monitor(uint32_t index) {
+    if (index >= (uint32_t) monitor_count_) {
+        printf("ERROR: Monitor '%u' doesn't exist, using the primary monitor.\n", index);
+        index = 0;
+    }
+
     monitor_ = available_monitors_[index];
 }
 
@@ -171,7 +243,7 @@ void engine_window_set_maximize(bool maximize) {
 }
 
 void engine_window_set_vsync(bool vsync) {
-    vsync_ = vsync;
+    vsync_ = vsync && !headless_; // Nothing to sync to offscreen
 
     glfwSwapInterval((int) vsync_);
 }
@@ -184,8 +256,8 @@ void engine_window_set_mode(int32_t window_mode) {
 
     if (window_mode_ == WINDOW_MODE_WINDOWED) {
 
-        int32_t pos_x = (window_width_  >= mode->width)  ? 0 : (mode->width  - window_width_)  / 2;
-        int32_t pos_y = (window_height_ >= mode->height) ? 0 : (mode->height - window_height_) / 2;
+        int32_t pos_x = (window_width_  >= (uint32_t) mode->width)  ? 0 : (mode->width  - window_width_)  / 2;
+        int32_t pos_y = (window_height_ >= (uint32_t) mode->height) ? 0 : (mode->height - window_height_) / 2;
 
         glfwSetWindowMonitor(
             window_, NULL,
@@ -200,10 +272,10 @@ void engine_window_set_mode(int32_t window_mode) {
             window_width_  = mode->width;
             window_height_ = mode->height;            
         } else {
-            if (window_width_ > mode->width) {
+            if (window_width_ > (uint32_t) mode->width) {
                 window_width_ = mode->width;
             }
-            if (window_height_ > mode->height) {
+            if (window_height_ > (uint32_t) mode->height) {
                 window_height_ = mode->height;
             }
         }
@@ -230,11 +302,9 @@ void engine_window_set_mode(int32_t window_mode) {
 }
 
 void engine_update_gl_viewport() {
-    if (retina_) {
-        glViewport(0, 0, window_width_ * 2, window_height_ * 2);
-    } else {
-        glViewport(0, 0, window_width_, window_height_);
-    }
+    vec2s size = engine_window_get_pixel_size();
+
+    glViewport(0, 0, size.x, size.y);
 }
 
 // Get
@@ -242,6 +312,16 @@ vec2s engine_window_get_size() {
     return (vec2s) { .x = window_width_, .y = window_height_ };
 }
 
+vec2s engine_window_get_pixel_size() {
+    uint32_t scale = (retina_) ? 2 : 1;
+
+    return (vec2s) { .x = window_width_ * scale, .y = window_height_ * scale };
+}
+
 bool engine_window_get_retina() {
     return retina_;
+}
+
+bool engine_window_headless() {
+    return headless_;
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #define WINDOW_MODE_WINDOWED_FULLSCREEN 2
 
 // Init
+void engine_window_set_headless(bool headless); // Before engine_init, hidden window rendering into a framebuffer
+
 bool engine_init_window();
 
 void engine_terminate_window();
@@ -30,4 +32,8 @@ void engine_update_gl_viewport();
 // Get
 vec2s engine_window_get_size();
 
-bool engine_window_get_retina();
\ No newline at end of file
+vec2s engine_window_get_pixel_size(); // Framebuffer size, doubled on retina
+
+bool engine_window_get_retina();
+
+bool engine_window_headless();
\ No newline at end of file
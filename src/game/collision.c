@@ -0,0 +1,430 @@
+#define HEAP_TAG HEAP_TAG_LEVEL
+#include "collision.h"
+
+#include "engine/trace.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+
+// Defines
+#define COLLISION_MAX_THREADS   16
+#define COLLISION_MAGIC         "CTCL"
+#define COLLISION_VERSION       1
+
+// Rectangles of a single chunk
+typedef struct CollisionChunkResult {
+    CollisionRect* rects;
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t solid_cells;
+} CollisionChunkResult;
+
+// Shared worker state, chunks are handed out through an atomic counter
+typedef struct CollisionJob {
+    Level* level;
+    const CollisionSolidSet* solid;
+
+    CollisionChunkResult* results;
+    uint32_t chunk_count;
+    uint32_t next_chunk;
+} CollisionJob;
+
+// Static
+static bool game_collision_is_solid(const CollisionSolidSet* set, int32_t tile) {
+    if (tile < 0 || tile > LEVEL_MAX_TILE_ID) {
+        return false;
+    }
+
+    return (set->bits[tile / 64] >> (tile % 64)) & 1;
+}
+
+static void game_collision_push(CollisionChunkResult* result, CollisionRect rect) {
+    if (result->count == result->capacity) {
+        result->capacity = (result->capacity) ? result->capacity * 2 : 16;
+        result->rects = (CollisionRect*) realloc(result->rects, sizeof(CollisionRect) * result->capacity);
+    }
+
+    result->rects[result->count++] = rect;
+}
+
+static void game_collision_mesh_chunk(CollisionJob* job, uint32_t index) {
+
+    Level* level = job->level;
+    LevelChunk* chunk = &level->chunks[index];
+
+    if (game_level_chunk_empty(chunk)) {
+        return;
+    }
+
+    uint32_t base_x = (index % level->chunks_per_row) * LEVEL_CHUNK_SIZE;
+    uint32_t base_y = (index / level->chunks_per_row) * LEVEL_CHUNK_SIZE;
+
+    CollisionChunkResult* result = &job->results[index];
+
+    // Solid mask, built only from the painted bits
+    uint64_t mask[LEVEL_CHUNK_SIZE] = {0};
+
+    for (uint32_t row = 0; row < LEVEL_CHUNK_SIZE; ++row) {
+        uint64_t word = chunk->rows[row];
+        if (word == 0) {
+            continue;
+        }
+
+        const int32_t* cells = level->data + (size_t) (base_y + row) * level->size + base_x;
+
+        while (word) {
+            uint32_t x = __builtin_ctzll(word);
+            word &= word - 1;
+
+            if (game_collision_is_solid(job->solid, cells[x])) {
+                mask[row] |= (uint64_t) 1 << x;
+            }
+        }
+
+        result->solid_cells += __builtin_popcountll(mask[row]);
+    }
+
+    // Greedy meshing, take the first run of a row and grow it down while the rows below cover it
+    for (uint32_t row = 0; row < LEVEL_CHUNK_SIZE; ++row) {
+        while (mask[row]) {
+
+            uint32_t start = __builtin_ctzll(mask[row]);
+            uint64_t run = ~(mask[row] >> start);
+            uint32_t width = (run == 0) ? LEVEL_CHUNK_SIZE - start : (uint32_t) __builtin_ctzll(run);
+
+            uint64_t run_mask = ((width == LEVEL_CHUNK_SIZE) ? ~(uint64_t) 0 : (((uint64_t) 1 << width) - 1)) << start;
+            mask[row] &= ~run_mask;
+
+            uint32_t height = 1;
+            while (row + height < LEVEL_CHUNK_SIZE && (mask[row + height] & run_mask) == run_mask) {
+                mask[row + height] &= ~run_mask;
+                height++;
+            }
+
+            game_collision_push(result, (CollisionRect) {
+                .x = base_x + start,
+                .y = base_y + row,
+                .width = width,
+                .height = height,
+            });
+        }
+    }
+}
+
+// Orders for the seam merge, rows of equal height, columns of equal width and the final bottom-left order
+static int game_collision_compare_rows(const void* a, const void* b) {
+    const CollisionRect* ra = (const CollisionRect*) a;
+    const CollisionRect* rb = (const CollisionRect*) b;
+
+    if (ra->y != rb->y) {
+        return (ra->y < rb->y) ? -1 : 1;
+    }
+    if (ra->height != rb->height) {
+        return (ra->height < rb->height) ? -1 : 1;
+    }
+    if (ra->x != rb->x) {
+        return (ra->x < rb->x) ? -1 : 1;
+    }
+    return 0;
+}
+
+static int game_collision_compare_columns(const void* a, const void* b) {
+    const CollisionRect* ra = (const CollisionRect*) a;
+    const CollisionRect* rb = (const CollisionRect*) b;
+
+    if (ra->x != rb->x) {
+        return (ra->x < rb->x) ? -1 : 1;
+    }
+    if (ra->width != rb->width) {
+        return (ra->width < rb->width) ? -1 : 1;
+    }
+    if (ra->y != rb->y) {
+        return (ra->y < rb->y) ? -1 : 1;
+    }
+    return 0;
+}
+
+static int game_collision_compare_position(const void* a, const void* b) {
+    const CollisionRect* ra = (const CollisionRect*) a;
+    const CollisionRect* rb = (const CollisionRect*) b;
+
+    if (ra->y != rb->y) {
+        return (ra->y < rb->y) ? -1 : 1;
+    }
+    if (ra->x != rb->x) {
+        return (ra->x < rb->x) ? -1 : 1;
+    }
+    return 0;
+}
+
+static void game_collision_merge_seams(CollisionLayer* layer) {
+
+    CollisionRect* rects = layer->rects;
+    uint32_t count = layer->count;
+
+    if (count < 2) {
+        return;
+    }
+
+    // Chunks mesh on their own, join rectangles that continue into the next chunk to the right
+    qsort(rects, count, sizeof(CollisionRect), game_collision_compare_rows);
+
+    uint32_t merged = 0;
+    for (uint32_t i = 1; i < count; ++i) {
+        CollisionRect* last = &rects[merged];
+
+        if (rects[i].y == last->y && rects[i].height == last->height && rects[i].x == last->x + last->width) {
+            last->width += rects[i].width;
+        } else {
+            rects[++merged] = rects[i];
+        }
+    }
+    count = merged + 1;
+
+    // Then the full width strips into the chunks above
+    qsort(rects, count, sizeof(CollisionRect), game_collision_compare_columns);
+
+    merged = 0;
+    for (uint32_t i = 1; i < count; ++i) {
+        CollisionRect* last = &rects[merged];
+
+        if (rects[i].x == last->x && rects[i].width == last->width && rects[i].y == last->y + last->height) {
+            last->height += rects[i].height;
+        } else {
+            rects[++merged] = rects[i];
+        }
+    }
+    count = merged + 1;
+
+    qsort(rects, count, sizeof(CollisionRect), game_collision_compare_position);
+
+    layer->count = count;
+}
+
+static void* game_collision_worker(void* data) {
+    CollisionJob* job = (CollisionJob*) data;
+
+    engine_trace_begin("collision_worker");
+
+    uint32_t index;
+    while ((index = __atomic_fetch_add(&job->next_chunk, 1, __ATOMIC_RELAXED)) < job->chunk_count) {
+        game_collision_mesh_chunk(job, index);
+    }
+
+    engine_trace_end("collision_worker");
+
+    return NULL;
+}
+
+// Solid set
+bool game_collision_parse_solid(CollisionSolidSet* set, const char* text) {
+
+    memset(set, 0, sizeof(CollisionSolidSet));
+
+    // Comma separated ids and inclusive ranges, "0,4,10-20"
+    const char* c = text;
+    while (*c) {
+
+        while (*c == ' ' || *c == ',') {
+            c++;
+        }
+        if (!*c) {
+            break;
+        }
+
+        char* end;
+        long first = strtol(c, &end, 10);
+        if (end == c) {
+            printf("ERROR: Failed to parse solid tiles from '%s'.\n", text);
+            return false;
+        }
+
+        long last = first;
+        c = end;
+
+        if (*c == '-') {
+            last = strtol(c + 1, &end, 10);
+            if (end == c + 1) {
+                printf("ERROR: Failed to parse solid tiles from '%s'.\n", text);
+                return false;
+            }
+            c = end;
+        }
+
+        if (first < 0 || last > LEVEL_MAX_TILE_ID || first > last) {
+            printf("ERROR: Solid tile range '%ld-%ld' is out of bounds.\n", first, last);
+            return false;
+        }
+
+        for (long tile = first; tile <= last; ++tile) {
+            set->bits[tile / 64] |= (uint64_t) 1 << (tile % 64);
+        }
+    }
+
+    return true;
+}
+
+bool game_collision_solid_empty(const CollisionSolidSet* set) {
+    for (uint32_t i = 0; i < (LEVEL_MAX_TILE_ID + 1) / 64; ++i) {
+        if (set->bits[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Creation & termination
+CollisionLayer* game_collision_build(Level* level, const CollisionSolidSet* solid) {
+
+    if (level->size > UINT16_MAX) {
+        printf("ERROR: Level size '%u' doesn't fit the collision format.\n", level->size);
+        return NULL;
+    }
+
+    uint32_t chunk_count = level->chunks_per_row * level->chunks_per_row;
+
+    CollisionJob job = (CollisionJob) {
+        .level = level,
+        .solid = solid,
+
+        .results = (CollisionChunkResult*) calloc(chunk_count, sizeof(CollisionChunkResult)),
+        .chunk_count = chunk_count,
+        .next_chunk = 0,
+    };
+
+    // Chunks are independent, mesh them in parallel
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    uint32_t thread_count = (cores > 0) ? (uint32_t) cores : 1;
+    if (thread_count > COLLISION_MAX_THREADS) {
+        thread_count = COLLISION_MAX_THREADS;
+    }
+    if (thread_count > chunk_count) {
+        thread_count = chunk_count;
+    }
+
+    pthread_t threads[COLLISION_MAX_THREADS];
+    uint32_t started = 0;
+
+    for (uint32_t i = 1; i < thread_count; ++i) {
+        if (pthread_create(&threads[started], NULL, game_collision_worker, &job) == 0) {
+            started++;
+        }
+    }
+
+    game_collision_worker(&job);
+
+    for (uint32_t i = 0; i < started; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    // Gather in chunk order, the seam merge sorts them into a deterministic order afterwards
+    uint32_t total = 0;
+    uint64_t solid_cells = 0;
+    for (uint32_t i = 0; i < chunk_count; ++i) {
+        total += job.results[i].count;
+        solid_cells += job.results[i].solid_cells;
+    }
+
+    CollisionLayer* layer = (CollisionLayer*) malloc(sizeof(CollisionLayer));
+    *layer = (CollisionLayer) {
+        .rects = (CollisionRect*) malloc(sizeof(CollisionRect) * ((total) ? total : 1)),
+        .count = total,
+
+        .level_size = level->size,
+        .solid_cells = solid_cells,
+    };
+
+    CollisionRect* out = layer->rects;
+    for (uint32_t i = 0; i < chunk_count; ++i) {
+        CollisionChunkResult* result = &job.results[i];
+        if (!result->count) {
+            continue;
+        }
+
+        memcpy(out, result->rects, sizeof(CollisionRect) * result->count);
+        out += result->count;
+
+        free(result->rects);
+    }
+
+    free(job.results);
+
+    game_collision_merge_seams(layer);
+
+    return layer;
+}
+
+void game_collision_free(CollisionLayer* layer) {
+    free(layer->rects);
+    free(layer);
+}
+
+// Export
+bool game_collision_write(const CollisionLayer* layer, const char* path, int32_t format) {
+
+    FILE* file;
+    if (!(file = fopen(path, "wb"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        return false;
+    }
+
+    if (format == COLLISION_FORMAT_BINARY) {
+
+        // Header followed by little endian u16 x, y, width, height per rectangle
+        uint8_t header[16] = {0};
+        memcpy(header, COLLISION_MAGIC, 4);
+
+        uint32_t fields[3] = { COLLISION_VERSION, layer->level_size, layer->count };
+        for (uint32_t i = 0; i < 3; ++i) {
+            header[4 + i * 4 + 0] = (uint8_t) (fields[i]);
+            header[4 + i * 4 + 1] = (uint8_t) (fields[i] >> 8);
+            header[4 + i * 4 + 2] = (uint8_t) (fields[i] >> 16);
+            header[4 + i * 4 + 3] = (uint8_t) (fields[i] >> 24);
+        }
+        fwrite(header, 1, sizeof(header), file);
+
+        uint8_t buffer[4096];
+        uint32_t used = 0;
+
+        for (uint32_t i = 0; i < layer->count; ++i) {
+            const CollisionRect* rect = &layer->rects[i];
+            uint16_t values[4] = { rect->x, rect->y, rect->width, rect->height };
+
+            for (uint32_t v = 0; v < 4; ++v) {
+                buffer[used++] = (uint8_t) (values[v]);
+                buffer[used++] = (uint8_t) (values[v] >> 8);
+            }
+
+            if (used == sizeof(buffer)) {
+                fwrite(buffer, 1, used, file);
+                used = 0;
+            }
+        }
+        fwrite(buffer, 1, used, file);
+
+    } else if (format == COLLISION_FORMAT_JSON) {
+
+        fprintf(file, "{\"version\":%d,\"origin\":\"bottom-left\",\"size\":%u,\"rects\":[", COLLISION_VERSION, layer->level_size);
+
+        for (uint32_t i = 0; i < layer->count; ++i) {
+            const CollisionRect* rect = &layer->rects[i];
+            fprintf(file, (i) ? ",\n[%u,%u,%u,%u]" : "\n[%u,%u,%u,%u]", rect->x, rect->y, rect->width, rect->height);
+        }
+
+        fprintf(file, "]}\n");
+
+    } else {
+        printf("ERROR: Unknown collision format '%d'.\n", format);
+        fclose(file);
+        return false;
+    }
+
+    if (fclose(file) != 0) {
+        printf("ERROR: Failed to write '%s'.\n", path);
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "util/common.h"
+
+#include "level.h"
+
+
+// Formats
+#define COLLISION_FORMAT_BINARY 0
+#define COLLISION_FORMAT_JSON   1
+
+// Set of tile ids treated as solid
+typedef struct CollisionSolidSet {
+    uint64_t bits[(LEVEL_MAX_TILE_ID + 1) / 64];
+} CollisionSolidSet;
+
+// Axis aligned rectangle in cells, origin at the bottom left of the level
+typedef struct CollisionRect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+} CollisionRect;
+
+// Collision layer
+typedef struct CollisionLayer {
+    CollisionRect* rects;
+    uint32_t count;
+
+    uint32_t level_size;
+    uint64_t solid_cells;
+} CollisionLayer;
+
+// Solid set
+bool game_collision_parse_solid(CollisionSolidSet* set, const char* text);
+
+bool game_collision_solid_empty(const CollisionSolidSet* set);
+
+// Creation & termination
+CollisionLayer* game_collision_build(Level* level, const CollisionSolidSet* solid);
+
+void game_collision_free(CollisionLayer* layer);
+
+// Export
+bool game_collision_write(const CollisionLayer* layer, const char* path, int32_t format);
\ No newline at end of file
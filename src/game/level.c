@@ -0,0 +1,650 @@
+#define HEAP_TAG HEAP_TAG_LEVEL
+#include "level.h"
+
+#include "util/file.h"
+
+
+// Defines
+#define LEVEL_DEFAULT_TILE_CAPACITY 256
+
+// Static
+static void game_level_reserve_tile_counts(Level* level, int32_t tile) {
+    LevelStats* stats = &level->stats;
+
+    if ((uint32_t) tile < stats->tile_capacity) {
+        return;
+    }
+
+    uint32_t capacity = stats->tile_capacity;
+    while (capacity <= (uint32_t) tile) {
+        capacity *= 2;
+    }
+    if (capacity > LEVEL_MAX_TILE_ID + 1) {
+        capacity = LEVEL_MAX_TILE_ID + 1;
+    }
+
+    stats->tile_counts = (uint32_t*) realloc(stats->tile_counts, sizeof(uint32_t) * capacity);
+    memset(stats->tile_counts + stats->tile_capacity, 0, sizeof(uint32_t) * (capacity - stats->tile_capacity));
+
+    stats->tile_capacity = capacity;
+}
+
+static uint32_t game_level_top_count(LevelStats* stats, int32_t slot) {
+    int32_t tile = stats->top_tiles[slot];
+    return (tile == LEVEL_EMPTY_TILE) ? 0 : stats->tile_counts[tile];
+}
+
+static void game_level_update_top(Level* level, int32_t tile) {
+    LevelStats* stats = &level->stats;
+
+    // Rebuilt on the next query anyway
+    if (stats->top_dirty) {
+        return;
+    }
+
+    int32_t* top = stats->top_tiles;
+    uint32_t count = stats->tile_counts[tile];
+
+    int32_t slot = -1;
+    for (int32_t i = 0; i < LEVEL_TOP_TILES; ++i) {
+        if (top[i] == tile) {
+            slot = i;
+            break;
+        }
+    }
+
+    if (slot == -1) {
+        if (count <= game_level_top_count(stats, LEVEL_TOP_TILES - 1)) {
+            stats->top_floor = (count > stats->top_floor) ? count : stats->top_floor;
+            return;
+        }
+
+        // Take the last slot, the evicted tile raises the floor
+        uint32_t evicted = game_level_top_count(stats, LEVEL_TOP_TILES - 1);
+        stats->top_floor = (evicted > stats->top_floor) ? evicted : stats->top_floor;
+
+        slot = LEVEL_TOP_TILES - 1;
+        top[slot] = tile;
+    }
+
+    if (count == 0) {
+        memmove(top + slot, top + slot + 1, (LEVEL_TOP_TILES - slot - 1) * sizeof(int32_t));
+        top[LEVEL_TOP_TILES - 1] = LEVEL_EMPTY_TILE;
+    } else {
+        while (slot > 0 && count > game_level_top_count(stats, slot - 1)) {
+            top[slot] = top[slot - 1];
+            top[--slot] = tile;
+        }
+        while (slot < LEVEL_TOP_TILES - 1 && count < game_level_top_count(stats, slot + 1)) {
+            top[slot] = top[slot + 1];
+            top[++slot] = tile;
+        }
+    }
+
+    // A tile outside may now outrank the last slot, only a rescan can tell
+    if (game_level_top_count(stats, LEVEL_TOP_TILES - 1) < stats->top_floor) {
+        stats->top_dirty = true;
+    }
+}
+
+static void game_level_rebuild_top(Level* level) {
+    LevelStats* stats = &level->stats;
+    int32_t* top = stats->top_tiles;
+
+    for (int32_t i = 0; i < LEVEL_TOP_TILES; ++i) {
+        top[i] = LEVEL_EMPTY_TILE;
+    }
+    stats->top_floor = 0;
+
+    for (uint32_t tile = 0; tile < stats->tile_capacity; ++tile) {
+        uint32_t count = stats->tile_counts[tile];
+        if (count == 0) {
+            continue;
+        }
+
+        uint32_t last = game_level_top_count(stats, LEVEL_TOP_TILES - 1);
+        if (count <= last) {
+            stats->top_floor = (count > stats->top_floor) ? count : stats->top_floor;
+            continue;
+        }
+        stats->top_floor = (last > stats->top_floor) ? last : stats->top_floor;
+
+        for (int32_t i = 0; i < LEVEL_TOP_TILES; ++i) {
+            if (count > game_level_top_count(stats, i)) {
+                memmove(top + i + 1, top + i, (LEVEL_TOP_TILES - i - 1) * sizeof(int32_t));
+                top[i] = tile;
+                break;
+            }
+        }
+    }
+
+    stats->top_dirty = false;
+}
+
+static void game_level_count_tile(Level* level, int32_t tile, int32_t amount) {
+    LevelStats* stats = &level->stats;
+
+    if (tile > LEVEL_MAX_TILE_ID) {
+        stats->invalid += amount;
+        return;
+    }
+
+    game_level_reserve_tile_counts(level, tile);
+
+    uint32_t* count = &stats->tile_counts[tile];
+    if (*count == 0 && amount > 0) {
+        stats->unique_tiles++;
+    }
+
+    *count += amount;
+
+    if (*count == 0) {
+        stats->unique_tiles--;
+    }
+
+    game_level_update_top(level, tile);
+}
+
+static void game_level_set_occupied(Level* level, int32_t x, int32_t y, bool occupied) {
+    LevelChunk* chunk = game_level_get_chunk(level, x / LEVEL_CHUNK_SIZE, y / LEVEL_CHUNK_SIZE);
+    uint64_t bit = (uint64_t) 1 << (x % LEVEL_CHUNK_SIZE);
+
+    if (occupied) {
+        chunk->rows[y % LEVEL_CHUNK_SIZE] |= bit;
+        chunk->count++;
+    } else {
+        chunk->rows[y % LEVEL_CHUNK_SIZE] &= ~bit;
+        chunk->count--;
+    }
+}
+
+static void game_level_reset_stats(Level* level) {
+    LevelStats* stats = &level->stats;
+
+    memset(stats->tile_counts, 0, sizeof(uint32_t) * stats->tile_capacity);
+    memset(stats->row_counts, 0, sizeof(uint32_t) * level->size);
+    memset(stats->col_counts, 0, sizeof(uint32_t) * level->size);
+
+    stats->unique_tiles = 0;
+    stats->painted = 0;
+    stats->invalid = 0;
+
+    stats->bounds = (LevelBounds) {0, 0, -1, -1};
+    stats->bounds_dirty = false;
+
+    // Bulk rebuilds count every cell, rank once on the next query instead
+    stats->top_dirty = true;
+
+    stats->version++;
+}
+
+// Creation & termination
+Level* game_level_new(uint32_t size) {
+
+    // Allocate memory for the level
+    Level* level = (Level*) malloc(sizeof(Level));
+
+    uint32_t chunks_per_row = (size + LEVEL_CHUNK_SIZE - 1) / LEVEL_CHUNK_SIZE;
+
+    *level = (Level) {
+        .data = (int32_t*) malloc(sizeof(int32_t) * size * size),
+        .size = size,
+
+        .chunks = (LevelChunk*) malloc(sizeof(LevelChunk) * chunks_per_row * chunks_per_row),
+        .chunks_per_row = chunks_per_row,
+
+        .stats = (LevelStats) {
+            .tile_counts = (uint32_t*) calloc(LEVEL_DEFAULT_TILE_CAPACITY, sizeof(uint32_t)),
+            .tile_capacity = LEVEL_DEFAULT_TILE_CAPACITY,
+
+            .row_counts = (uint32_t*) calloc(size, sizeof(uint32_t)),
+            .col_counts = (uint32_t*) calloc(size, sizeof(uint32_t)),
+        }
+    };
+
+    if (!level->data || !level->chunks) {
+        printf("ERROR: Failed to allocate level of size '%ux%u'.\n", size, size);
+
+        game_level_free(level);
+        return NULL;
+    }
+
+    game_level_clear(level);
+
+    return level;
+}
+
+void game_level_free(Level* level) {
+
+    free(level->stats.tile_counts);
+    free(level->stats.row_counts);
+    free(level->stats.col_counts);
+
+    free(level->chunks);
+    free(level->data);
+    free(level);
+}
+
+// Tiles
+int32_t game_level_get_tile(Level* level, int32_t x, int32_t y) {
+    if ((x < 0 || x >= (int32_t) level->size) || (y < 0 || y >= (int32_t) level->size)) {
+        return LEVEL_EMPTY_TILE;
+    }
+
+    return level->data[(y * level->size) + x];
+}
+
+void game_level_set_tile(Level* level, int32_t x, int32_t y, int32_t tile) {
+    if ((x < 0 || x >= (int32_t) level->size) || (y < 0 || y >= (int32_t) level->size)) {
+        return;
+    }
+
+    if (tile < 0) {
+        tile = LEVEL_EMPTY_TILE;
+    }
+
+    int32_t* cell = &level->data[(y * level->size) + x];
+    int32_t previous = *cell;
+
+    if (previous == tile) {
+        return;
+    }
+
+    *cell = tile;
+
+    LevelStats* stats = &level->stats;
+    stats->version++;
+
+    // Replacing a painted tile only moves the histogram
+    if (previous != LEVEL_EMPTY_TILE && tile != LEVEL_EMPTY_TILE) {
+        game_level_count_tile(level, previous, -1);
+        game_level_count_tile(level, tile, 1);
+        return;
+    }
+
+    // Painting an empty cell
+    if (tile != LEVEL_EMPTY_TILE) {
+        game_level_count_tile(level, tile, 1);
+        game_level_set_occupied(level, x, y, true);
+
+        stats->row_counts[y]++;
+        stats->col_counts[x]++;
+
+        if (stats->painted++ == 0) {
+            stats->bounds = (LevelBounds) {x, y, x, y};
+        } else if (!stats->bounds_dirty) {
+            stats->bounds.min_x = (x < stats->bounds.min_x) ? x : stats->bounds.min_x;
+            stats->bounds.min_y = (y < stats->bounds.min_y) ? y : stats->bounds.min_y;
+            stats->bounds.max_x = (x > stats->bounds.max_x) ? x : stats->bounds.max_x;
+            stats->bounds.max_y = (y > stats->bounds.max_y) ? y : stats->bounds.max_y;
+        }
+
+        return;
+    }
+
+    // Erasing a painted cell, the bounds only shrink if an edge row or column empties
+    game_level_count_tile(level, previous, -1);
+    game_level_set_occupied(level, x, y, false);
+
+    stats->painted--;
+
+    if (--stats->row_counts[y] == 0 && (y == stats->bounds.min_y || y == stats->bounds.max_y)) {
+        stats->bounds_dirty = true;
+    }
+    if (--stats->col_counts[x] == 0 && (x == stats->bounds.min_x || x == stats->bounds.max_x)) {
+        stats->bounds_dirty = true;
+    }
+}
+
+// Chunks
+LevelChunk* game_level_get_chunk(Level* level, uint32_t chunk_x, uint32_t chunk_y) {
+    return &level->chunks[(chunk_y * level->chunks_per_row) + chunk_x];
+}
+
+bool game_level_chunk_empty(const LevelChunk* chunk) {
+    return chunk->count == 0;
+}
+
+uint64_t game_level_occupancy(Level* level, uint32_t chunk_x, uint32_t y) {
+    return game_level_get_chunk(level, chunk_x, y / LEVEL_CHUNK_SIZE)->rows[y % LEVEL_CHUNK_SIZE];
+}
+
+void game_level_visit(Level* level, LevelBounds view, LevelVisitor visitor, void* user) {
+
+    int32_t last = (int32_t) level->size - 1;
+
+    view.min_x = (view.min_x < 0) ? 0 : view.min_x;
+    view.min_y = (view.min_y < 0) ? 0 : view.min_y;
+    view.max_x = (view.max_x > last) ? last : view.max_x;
+    view.max_y = (view.max_y > last) ? last : view.max_y;
+
+    if (view.min_x > view.max_x || view.min_y > view.max_y) {
+        return;
+    }
+
+    // Walk the occupancy bitmaps of the visible chunks, empty cells are never touched
+    for (int32_t chunk_y = view.min_y / LEVEL_CHUNK_SIZE; chunk_y <= view.max_y / LEVEL_CHUNK_SIZE; ++chunk_y) {
+        for (int32_t chunk_x = view.min_x / LEVEL_CHUNK_SIZE; chunk_x <= view.max_x / LEVEL_CHUNK_SIZE; ++chunk_x) {
+
+            LevelChunk* chunk = game_level_get_chunk(level, chunk_x, chunk_y);
+            if (game_level_chunk_empty(chunk)) {
+                continue;
+            }
+
+            int32_t base_x = chunk_x * LEVEL_CHUNK_SIZE;
+            int32_t base_y = chunk_y * LEVEL_CHUNK_SIZE;
+
+            // Mask off the columns outside the view
+            uint64_t mask = ~(uint64_t) 0;
+            if (view.min_x > base_x) {
+                mask &= ~(uint64_t) 0 << (view.min_x - base_x);
+            }
+            if (view.max_x - base_x < LEVEL_CHUNK_SIZE - 1) {
+                mask &= ~(uint64_t) 0 >> (LEVEL_CHUNK_SIZE - 1 - (view.max_x - base_x));
+            }
+
+            int32_t first_row = (view.min_y > base_y) ? view.min_y - base_y : 0;
+            int32_t last_row  = (view.max_y - base_y < LEVEL_CHUNK_SIZE - 1) ? view.max_y - base_y : LEVEL_CHUNK_SIZE - 1;
+
+            for (int32_t row = first_row; row <= last_row; ++row) {
+
+                uint64_t word = chunk->rows[row] & mask;
+                int32_t y = base_y + row;
+                const int32_t* cells = level->data + (size_t) y * level->size;
+
+                while (word) {
+                    int32_t x = base_x + __builtin_ctzll(word);
+                    word &= word - 1;
+
+                    visitor(x, y, cells[x], user);
+                }
+            }
+        }
+    }
+}
+
+// Bulk operations
+void game_level_clear(Level* level) {
+
+    size_t level_size = (size_t) level->size * level->size;
+    for (size_t i = 0; i < level_size; ++i) {
+        level->data[i] = LEVEL_EMPTY_TILE;
+    }
+
+    memset(level->chunks, 0, sizeof(LevelChunk) * level->chunks_per_row * level->chunks_per_row);
+
+    game_level_reset_stats(level);
+}
+
+void game_level_fill(Level* level, int32_t tile) {
+
+    if (tile < 0) {
+        game_level_clear(level);
+        return;
+    }
+
+    uint32_t size = level->size;
+    size_t level_size = (size_t) size * size;
+    for (size_t i = 0; i < level_size; ++i) {
+        level->data[i] = tile;
+    }
+
+    // Every cell is painted, the stats are known without looking at them
+    game_level_reset_stats(level);
+
+    memset(level->chunks, 0, sizeof(LevelChunk) * level->chunks_per_row * level->chunks_per_row);
+
+    for (uint32_t chunk_x = 0; chunk_x < level->chunks_per_row; ++chunk_x) {
+
+        uint32_t width = size - chunk_x * LEVEL_CHUNK_SIZE;
+        uint64_t word = (width >= LEVEL_CHUNK_SIZE) ? ~(uint64_t) 0 : ((uint64_t) 1 << width) - 1;
+
+        for (uint32_t y = 0; y < size; ++y) {
+            LevelChunk* chunk = game_level_get_chunk(level, chunk_x, y / LEVEL_CHUNK_SIZE);
+            chunk->rows[y % LEVEL_CHUNK_SIZE] = word;
+            chunk->count += __builtin_popcountll(word);
+        }
+    }
+
+    LevelStats* stats = &level->stats;
+    for (uint32_t i = 0; i < size; ++i) {
+        stats->row_counts[i] = size;
+        stats->col_counts[i] = size;
+    }
+
+    stats->painted = level_size;
+    stats->bounds = (LevelBounds) {0, 0, size - 1, size - 1};
+
+    game_level_count_tile(level, tile, (int32_t) level_size);
+}
+
+uint64_t game_level_replace(Level* level, int32_t from, int32_t to) {
+
+    from = (from < 0) ? LEVEL_EMPTY_TILE : from;
+    to = (to < 0) ? LEVEL_EMPTY_TILE : to;
+
+    if (from == to) {
+        return 0;
+    }
+
+    uint32_t size = level->size;
+    uint64_t replaced = 0;
+
+    // Painting empty cells changes the occupancy, go through the regular path
+    if (from == LEVEL_EMPTY_TILE) {
+        for (uint32_t y = 0; y < size; ++y) {
+            const int32_t* row = level->data + (size_t) y * size;
+
+            for (uint32_t x = 0; x < size; ++x) {
+                if (row[x] == LEVEL_EMPTY_TILE) {
+                    game_level_set_tile(level, x, y, to);
+                    replaced++;
+                }
+            }
+        }
+
+        return replaced;
+    }
+
+    // Only painted cells can match, walk the bitmaps
+    uint32_t chunk_count = level->chunks_per_row * level->chunks_per_row;
+    for (uint32_t i = 0; i < chunk_count; ++i) {
+
+        LevelChunk* chunk = &level->chunks[i];
+        if (game_level_chunk_empty(chunk)) {
+            continue;
+        }
+
+        uint32_t base_x = (i % level->chunks_per_row) * LEVEL_CHUNK_SIZE;
+        uint32_t base_y = (i / level->chunks_per_row) * LEVEL_CHUNK_SIZE;
+
+        for (uint32_t row = 0; row < LEVEL_CHUNK_SIZE; ++row) {
+
+            uint64_t word = chunk->rows[row];
+            int32_t* cells = level->data + (size_t) (base_y + row) * size + base_x;
+
+            while (word) {
+                uint32_t x = __builtin_ctzll(word);
+                word &= word - 1;
+
+                if (cells[x] != from) {
+                    continue;
+                }
+
+                // Erasing updates the occupancy and bounds
+                if (to == LEVEL_EMPTY_TILE) {
+                    game_level_set_tile(level, base_x + x, base_y + row, LEVEL_EMPTY_TILE);
+                } else {
+                    cells[x] = to;
+                }
+
+                replaced++;
+            }
+        }
+    }
+
+    // Tile to tile only moves the histogram
+    if (replaced && to != LEVEL_EMPTY_TILE) {
+        game_level_count_tile(level, from, -(int32_t) replaced);
+        game_level_count_tile(level, to, (int32_t) replaced);
+
+        level->stats.version++;
+    }
+
+    return replaced;
+}
+
+void game_level_recalculate_stats(Level* level) {
+
+    game_level_reset_stats(level);
+
+    LevelStats* stats = &level->stats;
+    uint32_t size = level->size;
+
+    memset(level->chunks, 0, sizeof(LevelChunk) * level->chunks_per_row * level->chunks_per_row);
+
+    for (uint32_t y = 0; y < size; ++y) {
+
+        int32_t* row = level->data + ((size_t) y * size);
+        uint32_t row_count = 0;
+
+        for (uint32_t chunk_x = 0; chunk_x < level->chunks_per_row; ++chunk_x) {
+
+            uint32_t start = chunk_x * LEVEL_CHUNK_SIZE;
+            uint32_t end = (start + LEVEL_CHUNK_SIZE < size) ? start + LEVEL_CHUNK_SIZE : size;
+
+            // Branchless bitmap build, kept simple so the compiler can vectorize it
+            uint64_t word = 0;
+            for (uint32_t x = start; x < end; ++x) {
+                word |= (uint64_t) (row[x] >= 0) << (x - start);
+            }
+
+            if (word == 0) {
+                continue;
+            }
+
+            LevelChunk* chunk = game_level_get_chunk(level, chunk_x, y / LEVEL_CHUNK_SIZE);
+            chunk->rows[y % LEVEL_CHUNK_SIZE] = word;
+
+            uint32_t count = __builtin_popcountll(word);
+            chunk->count += count;
+            row_count += count;
+
+            // Only painted cells need the histogram pass
+            while (word) {
+                uint32_t x = start + __builtin_ctzll(word);
+                word &= word - 1;
+
+                stats->col_counts[x]++;
+                game_level_count_tile(level, row[x], 1);
+            }
+        }
+
+        stats->row_counts[y] = row_count;
+        stats->painted += row_count;
+
+        // Normalize anything negative to the empty tile
+        for (uint32_t x = 0; x < size; ++x) {
+            row[x] = (row[x] < 0) ? LEVEL_EMPTY_TILE : row[x];
+        }
+    }
+
+    stats->bounds_dirty = (stats->painted != 0);
+}
+
+// Raw cells
+bool game_level_write_raw(Level* level, const char* path, size_t* written) {
+
+    FILE* file;
+    if (!(file = fopen(path, "wb"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        return false;
+    }
+
+    size_t cells = (size_t) level->size * level->size;
+    *written = fwrite(level->data, sizeof(int32_t), cells, file);
+
+    if (fclose(file) != 0 || *written != cells) {
+        printf("ERROR: Failed to write '%s'.\n", path);
+        return false;
+    }
+
+    return true;
+}
+
+bool game_level_read_raw(Level* level, const char* path, size_t* read) {
+
+    FileView file;
+    if (!file_load(&file, path, FILE_LOAD_MAP)) {
+        return false;
+    }
+
+    size_t level_bytes = sizeof(int32_t) * level->size * level->size;
+    size_t read_bytes = (file.size < level_bytes) ? file.size - (file.size % sizeof(int32_t)) : level_bytes;
+
+    memcpy(level->data, file.data, read_bytes);
+    file_release(&file);
+
+    *read = read_bytes / sizeof(int32_t);
+
+    // Rebuild the stats once after the bulk read
+    game_level_recalculate_stats(level);
+
+    return true;
+}
+
+// Stats
+uint32_t game_level_tile_count(Level* level, int32_t tile) {
+    if (tile < 0 || (uint32_t) tile >= level->stats.tile_capacity) {
+        return 0;
+    }
+
+    return level->stats.tile_counts[tile];
+}
+
+double game_level_painted_fraction(Level* level) {
+    return (double) level->stats.painted / ((double) level->size * level->size);
+}
+
+bool game_level_bounds(Level* level, LevelBounds* bounds) {
+    LevelStats* stats = &level->stats;
+
+    if (stats->painted == 0) {
+        return false;
+    }
+
+    // Rebuild from the row and column counts instead of rescanning the cells
+    if (stats->bounds_dirty) {
+        int32_t size = (int32_t) level->size;
+
+        int32_t min_y = 0, max_y = size - 1;
+        while (stats->row_counts[min_y] == 0) { min_y++; }
+        while (stats->row_counts[max_y] == 0) { max_y--; }
+
+        int32_t min_x = 0, max_x = size - 1;
+        while (stats->col_counts[min_x] == 0) { min_x++; }
+        while (stats->col_counts[max_x] == 0) { max_x--; }
+
+        stats->bounds = (LevelBounds) {min_x, min_y, max_x, max_y};
+        stats->bounds_dirty = false;
+    }
+
+    *bounds = stats->bounds;
+    return true;
+}
+
+uint32_t game_level_top_tiles(Level* level, int32_t* tiles) {
+    LevelStats* stats = &level->stats;
+
+    if (stats->top_dirty) {
+        game_level_rebuild_top(level);
+    }
+
+    uint32_t count = 0;
+    while (count < LEVEL_TOP_TILES && stats->top_tiles[count] != LEVEL_EMPTY_TILE) {
+        tiles[count] = stats->top_tiles[count];
+        count++;
+    }
+
+    return count;
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Defines
+#define LEVEL_EMPTY_TILE    -1
+#define LEVEL_MAX_TILE_ID   65535
+#define LEVEL_CHUNK_SIZE    64 // One bitmap word per chunk row
+#define LEVEL_TOP_TILES     5
+
+// Bounding box of the painted cells, inclusive
+typedef struct LevelBounds {
+    int32_t min_x;
+    int32_t min_y;
+    int32_t max_x;
+    int32_t max_y;
+} LevelBounds;
+
+// Statistics, kept up to date on every write
+typedef struct LevelStats {
+    uint32_t* tile_counts; // Indexed by tile id
+    uint32_t tile_capacity;
+    uint32_t unique_tiles;
+
+    int32_t top_tiles[LEVEL_TOP_TILES]; // Most used ids by count, LEVEL_EMPTY_TILE for unused slots
+    uint32_t top_floor; // Upper bound of the counts outside the top tiles
+    bool top_dirty;
+
+    uint64_t painted;
+    uint64_t invalid; // Painted cells with an id above LEVEL_MAX_TILE_ID
+
+    uint32_t* row_counts;
+    uint32_t* col_counts;
+
+    LevelBounds bounds;
+    bool bounds_dirty;
+
+    uint32_t version; // Incremented on every change
+} LevelStats;
+
+// Occupancy bitmap of a chunk, bit x of rows[y] is set for painted cells
+typedef struct LevelChunk {
+    uint64_t rows[LEVEL_CHUNK_SIZE];
+    uint32_t count;
+} LevelChunk;
+
+// Called for every painted cell inside a view
+typedef void (*LevelVisitor)(int32_t x, int32_t y, int32_t tile, void* user);
+
+// Level
+typedef struct Level {
+    int32_t* data;
+    uint32_t size;
+
+    LevelChunk* chunks;
+    uint32_t chunks_per_row;
+
+    LevelStats stats;
+} Level;
+
+// Creation & termination
+Level* game_level_new(uint32_t size);
+
+void game_level_free(Level* level);
+
+// Tiles
+int32_t game_level_get_tile(Level* level, int32_t x, int32_t y);
+
+void game_level_set_tile(Level* level, int32_t x, int32_t y, int32_t tile);
+
+// Chunks
+LevelChunk* game_level_get_chunk(Level* level, uint32_t chunk_x, uint32_t chunk_y);
+
+bool game_level_chunk_empty(const LevelChunk* chunk);
+
+uint64_t game_level_occupancy(Level* level, uint32_t chunk_x, uint32_t y);
+
+void game_level_visit(Level* level, LevelBounds view, LevelVisitor visitor, void* user); // Inclusive view, clamped to the level
+
+// Bulk operations
+void game_level_clear(Level* level);
+
+void game_level_fill(Level* level, int32_t tile);
+
+uint64_t game_level_replace(Level* level, int32_t from, int32_t to); // Returns the number of cells changed
+
+void game_level_recalculate_stats(Level* level);
+
+// Raw cells, row major little endian int32
+bool game_level_write_raw(Level* level, const char* path, size_t* written);
+
+bool game_level_read_raw(Level* level, const char* path, size_t* read); // A shorter file leaves the rest of the level as it was
+
+// Stats
+uint32_t game_level_tile_count(Level* level, int32_t tile);
+
+double game_level_painted_fraction(Level* level);
+
+bool game_level_bounds(Level* level, LevelBounds* bounds);
+
+uint32_t game_level_top_tiles(Level* level, int32_t* tiles); // Fills up to LEVEL_TOP_TILES ids, most used first
\ No newline at end of file
@@ -6,7 +6,7 @@ static uint32_t active_scene_id_ = -1;
 
 // Get
 uint32_t game_scene_get_new_id() {
-    return active_scene_id_++;
+    return next_scene_id_++;
 }
 
 uint32_t game_scene_get_active_scene() {
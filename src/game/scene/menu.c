@@ -1,5 +1,10 @@
 #include "menu.h"
 
+#include "game/level.h"
+#include "game/tiled.h"
+#include "game/collision.h"
+#include "game/tilepicker.h"
+
 #include "game/ui/ui.h"
 #include "game/ui/label.h"
 #include "game/ui/button.h"
@@ -12,56 +17,64 @@
 #include "engine/renderer.h"
 #include "engine/font.h"
 #include "engine/texture.h"
+#include "engine/settings.h"
+#include "engine/overlay.h"
+#include "engine/profiler.h"
+#include "engine/trace.h"
 
-#include "util/list.h"
-#include "util/map.h"
-#include "parser/parser.h"
+#include "util/vector.h"
+#include "util/file.h"
 
 
 // Add scene definitions
 SCENE_DEFINE(menu);
 
-// Defines
-#define DEFAULT_LEVEL_SIZE  512
-#define DEFAULT_TILE_SIZE   32
-
 static uint32_t level_size_ = 512;
 static uint32_t tile_size_  = 32;
 
 // Static elements
 static UINode* panel;
 static UINode* level_path_node;
+static UINode* solid_tiles_node;
 static UINode* tileset_node;
 static UINode* tileset_width_node;
 static UINode* tileset_height_node;
 
+// Stats panel
+static UINode* stats_panel_;
+static UINode* stats_painted_node_;
+static UINode* stats_bounds_node_;
+static UINode* stats_unique_node_;
+static UINode* stats_selected_node_;
+static UINode* stats_top_nodes_[LEVEL_TOP_TILES];
+static uint32_t stats_version_;
+static int32_t stats_selected_;
+
 // State
 static bool can_place_tiles_ = true;
 static bool show_exit_panel_ = false;
+static bool show_stats_panel_ = false;
+
+// Hot reload
+static uint32_t settings_version_;
+static uint32_t tileset_version_;
 
 // Resources
 static Font* default_font_;
 
 // Level
-static int32_t* level_data_;
+static Level* level_;
 
 // Camera
 typedef struct Camera {
     vec2s position;
+    vec2s previous; // Position before the last tick
+    vec2s view; // Blended between the two, what gets drawn and clicked on
 } Camera;
 
 static Camera camera_;
 static double camera_speed_ = 200.0f;
 
-// Tile
-typedef struct Tile {
-    vec2s pos;
-    vec4s source;
-    float size;
-    uint32_t index;
-} Tile;
-LIST_DECLARE(Tile);
-
 // Tilepicker
 typedef struct Tilepicker {
     vec3s pos;
@@ -78,7 +91,7 @@ typedef struct Tilepicker {
 
     float total_height;
     int32_t max_index;
-    LIST_TYPE(Tile) tiles;
+    VECTOR(Tile) tiles;
     int32_t selected_tile;
 } Tilepicker;
 
@@ -94,75 +107,157 @@ void close_exit_panel() {
     can_place_tiles_ = true;
 }
 
-void save_map() {
+void write_map() {
     UIInput* level_path_input = ui_input_get(level_path_node);
-    const char* path = level_path_input->buffer->array;
+    const char* path = level_path_input->buffer.array;
 
     printf("INFO: Saving level to '%s'.\n", path);
 
-    if (level_path_input->buffer->count == 0) {
+    if (level_path_input->buffer.count == 0) {
         printf("ERROR: Filename can't be empty.\n");
         return;
     }
 
-    FILE* file = fopen(path, "w");
-    int32_t written = fwrite(level_data_, sizeof(int32_t), (level_size_ * level_size_), file);
+    // Export to Tiled if the extension asks for it
+    int32_t format = game_tiled_format_from_path(path);
+    if (format != TILED_FORMAT_NONE) {
+
+        TiledTileset tileset = (TiledTileset) {
+            .image = NULL,
+            .tile_width = tile_size_,
+            .tile_height = tile_size_,
+        };
+
+        if (tilepicker_->show_tileset) {
+            tileset = (TiledTileset) {
+                .image = ui_input_get(tileset_node)->buffer.array,
+                .image_width = tilepicker_->tileset->width,
+                .image_height = tilepicker_->tileset->height,
+
+                .tile_width = tilepicker_->tile_width,
+                .tile_height = tilepicker_->tile_height,
+            };
+        }
+
+        if (game_tiled_export(level_, path, format, TILED_COMPRESSION_ZLIB, &tileset)) {
+            printf("INFO: Level has been exported.\n");
+        }
+        return;
+    }
+
+    size_t written;
+    if (!game_level_write_raw(level_, path, &written)) {
+        return;
+    }
 
     printf("INFO: Level has been saved, written %.2f MB of memory.\n", ((double)written * 4) / pow(2, 20));
 }
 
-void load_map() {
+void read_map() {
     UIInput* level_path_input = ui_input_get(level_path_node);
-    const char* path = level_path_input->buffer->array;
+    const char* path = level_path_input->buffer.array;
 
     printf("INFO: Loading level from '%s'.\n", path);
 
-    FILE* file;
-    if (!(file = fopen(path, "r"))) {
-        printf("ERROR: File '%s' could not be opened.\n", path);
+    // Import from Tiled if the extension asks for it
+    int32_t format = game_tiled_format_from_path(path);
+    if (format != TILED_FORMAT_NONE) {
+        if (game_tiled_import(level_, path, format)) {
+            printf("INFO: Level has been imported.\n");
+        }
         return;
     }
 
-    uint32_t read = fread(level_data_, sizeof(int32_t), (level_size_ * level_size_), file);
+    // Raw cells, a shorter file leaves the rest of the level as it was
+    size_t read;
+    if (!game_level_read_raw(level_, path, &read)) {
+        return;
+    }
 
     printf("INFO: Level has been loaded, read %.2f MB of memory.\n", ((double)read * 4) / pow(2, 20));
 }
 
-void clear_map() {
-    printf("INFO: Clearing the level.\n");
+// Timed, so hitches around saving and loading show up in the profiler and traces
+void save_map() {
+    engine_profiler_begin("save_map");
+    write_map();
+    engine_profiler_end();
+}
 
-    size_t level_size = (level_size_ * level_size_);
-    for (int i = 0; i< level_size; ++i) {
-        level_data_[i] = -1;
-    }
+void load_map() {
+    engine_profiler_begin("load_map");
+    read_map();
+    engine_profiler_end();
 }
 
-void reload_tilepicker() {
+void export_collision() {
+    UIInput* level_path_input = ui_input_get(level_path_node);
+    UIInput* solid_input = ui_input_get(solid_tiles_node);
 
-    UIInput* tileset_input = ui_input_get(tileset_node);
-    FILE* path = fopen(tileset_input->buffer->array, "r");
-    if (!path) {
-        printf("ERROR: File could not be located to load tileset.\n");
+    if (level_path_input->buffer.count == 0) {
+        printf("ERROR: Filename can't be empty.\n");
+        return;
+    }
 
-        // If tileset could not be loaded don't show it
-        tilepicker_->show_tileset = false;
+    // Only needed for this frame
+    CollisionSolidSet* solid = (CollisionSolidSet*) engine_frame_alloc(sizeof(CollisionSolidSet));
+    if (!game_collision_parse_solid(solid, (solid_input->buffer.count) ? solid_input->buffer.array : "")) {
+        return;
+    }
 
+    // The field only shows an example, an empty set would write an empty layer
+    if (game_collision_solid_empty(solid)) {
+        printf("ERROR: No solid tiles given, list their ids like '0,4,10-20'.\n");
         return;
-    } 
+    }
 
-    // Reload the tileset
-    if (tilepicker_->tileset) {
-        engine_texture_free(tilepicker_->tileset); 
+    double start = glfwGetTime();
+    CollisionLayer* layer = game_collision_build(level_, solid);
+    double elapsed = glfwGetTime() - start;
+
+    if (!layer) {
+        return;
     }
 
-    tilepicker_->tileset = engine_texture_new(tileset_input->buffer->array, GL_NEAREST);
+    // Tiled maps get a JSON layer next to them, raw levels get the binary one
+    const char* level_path = level_path_input->buffer.array;
+    bool json = game_tiled_format_from_path(level_path) != TILED_FORMAT_NONE;
+
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", level_path, (json) ? ".collision.json" : ".col");
+
+    printf(
+        "INFO: Merged %" PRIu64 " solid cells into %u rectangles in %.2f ms.\n", 
+        layer->solid_cells, layer->count, elapsed * 1000.0
+    );
+
+    if (!layer->count) {
+        printf("WARNING: None of the solid tiles are painted, the collision layer is empty.\n");
+    }
+
+    if (game_collision_write(layer, path, (json) ? COLLISION_FORMAT_JSON : COLLISION_FORMAT_BINARY)) {
+        printf("INFO: Collision layer has been written to '%s'.\n", path);
+    }
+
+    game_collision_free(layer);
+}
+
+void clear_map() {
+    printf("INFO: Clearing the level.\n");
+
+    game_level_clear(level_);
+}
+
+void rebuild_tilepicker_tiles() {
+
+    tileset_version_ = tilepicker_->tileset->version;
 
     // Reload the size
     UIInput* tileset_width_input  = ui_input_get(tileset_width_node);
     UIInput* tileset_height_input = ui_input_get(tileset_height_node);
 
-    tilepicker_->tile_width  = atoi(tileset_width_input->buffer->array);
-    tilepicker_->tile_height = atoi(tileset_height_input->buffer->array);
+    tilepicker_->tile_width  = atoi(tileset_width_input->buffer.array);
+    tilepicker_->tile_height = atoi(tileset_height_input->buffer.array);
 
     // If width or height is 0 don't show tileset
     if (!(tilepicker_->tile_width && tilepicker_->tile_height)) {
@@ -172,7 +267,7 @@ void reload_tilepicker() {
     }
 
     // Recreate tiles
-    LIST_CLEAR(tilepicker_->tiles);
+    VECTOR_CLEAR(&tilepicker_->tiles);
 
     uint32_t tile_in_row = tilepicker_->tileset->width  / tilepicker_->tile_width;
     uint32_t tile_in_col = tilepicker_->tileset->height / tilepicker_->tile_height;
@@ -184,7 +279,9 @@ void reload_tilepicker() {
     tilepicker_->max_scroll = tilepicker_->total_height - tilepicker_->size.y;
     tilepicker_->max_index = tile_count - 1;
 
-    for (int32_t i = 0; i < tile_count; ++i) {
+    VECTOR_RESERVE(&tilepicker_->tiles, tile_count);
+
+    for (uint32_t i = 0; i < tile_count; ++i) {
 
         Tile tile = (Tile) {
             .pos = (vec2s) {
@@ -201,13 +298,67 @@ void reload_tilepicker() {
             .index = i
         };
 
-        LIST_PUSH(tilepicker_->tiles, tile);
+        VECTOR_PUSH(&tilepicker_->tiles, tile);
     }
 
+    // Give back the memory of a previously larger tileset
+    VECTOR_SHRINK_TO_FIT(&tilepicker_->tiles);
+
     // Show tileset
     tilepicker_->show_tileset = true;
 }
 
+void reload_tilepicker() {
+
+    UIInput* tileset_input = ui_input_get(tileset_node);
+    FILE* path = fopen(tileset_input->buffer.array, "r");
+    if (!path) {
+        printf("ERROR: File could not be located to load tileset.\n");
+
+        // If tileset could not be loaded don't show it
+        tilepicker_->show_tileset = false;
+
+        return;
+    } 
+    fclose(path);
+
+    // Reload the tileset
+    if (tilepicker_->tileset) {
+        engine_texture_free(tilepicker_->tileset); 
+    }
+
+    tilepicker_->tileset = engine_texture_new(tileset_input->buffer.array, GL_NEAREST);
+    if (!tilepicker_->tileset) {
+        tilepicker_->show_tileset = false;
+        return;
+    }
+
+    rebuild_tilepicker_tiles();
+}
+
+void apply_reloads() {
+
+    // Settings, the level size only applies to new levels
+    const EngineSettings* settings = engine_settings_get();
+    if (settings->version != settings_version_) {
+        settings_version_ = settings->version;
+
+        if ((uint32_t) settings->tile_size != tile_size_) {
+            tile_size_ = settings->tile_size;
+            printf("INFO: Tile size is set to '%dx%d'.\n", tile_size_, tile_size_);
+        }
+
+        if ((uint32_t) settings->level_size != level_size_) {
+            printf("INFO: Level size change to '%d' applies after a restart.\n", settings->level_size);
+        }
+    }
+
+    // Tileset, the image might have a different size now
+    if (tilepicker_->tileset && tilepicker_->tileset->version != tileset_version_) {
+        rebuild_tilepicker_tiles();
+    }
+}
+
 void render_tilepicker(Shader shader) {
 
     // Draw the tilepicker background
@@ -226,13 +377,13 @@ void render_tilepicker(Shader shader) {
     if (tilepicker_->show_tileset) {
 
         vec2s render_size = {
-            LIST_GET(tilepicker_->tiles, 0).size,
-            LIST_GET(tilepicker_->tiles, 0).size
+            VECTOR_GET(&tilepicker_->tiles, 0).size,
+            VECTOR_GET(&tilepicker_->tiles, 0).size
         };
         
-        for (int32_t i = 0; i < tilepicker_->tiles->count; ++i) {
+        for (uint32_t i = 0; i < tilepicker_->tiles.count; ++i) {
 
-            Tile* current = &LIST_GET(tilepicker_->tiles, i);
+            Tile* current = &VECTOR_GET(&tilepicker_->tiles, i);
 
             vec3 render_pos = {
                 current->pos.x,
@@ -281,27 +432,10 @@ void update_tilepicker(const double* scroll_input, const double* cursor_pos) {
     }
 
     // Select tiles
-    bool selected = false;
-    for (int32_t i = 0; i < tilepicker_->tiles->count; ++i) {
-
-        Tile* current = &LIST_GET(tilepicker_->tiles, i);
-
-        vec2s current_pos = (vec2s) {
-            current->pos.x,
-            tilepicker_->render_offset + current->pos.y,
-        };
-
-        if ((cursor_pos[0] >= current_pos.x && cursor_pos[0] <= current_pos.x + current->size) &&
-            (cursor_pos[1] >= current_pos.y && cursor_pos[1] <= current_pos.y + current->size)) {
-        
-            if (action.just_pressed) {
-                tilepicker_->selected_tile = current->index;
-                selected = true;
-            }
-        }
-
-        if (selected) {
-            break;
+    if (action.just_pressed) {
+        int32_t hit = game_tilepicker_hit(&tilepicker_->tiles, tilepicker_->render_offset, cursor_pos);
+        if (hit >= 0) {
+            tilepicker_->selected_tile = hit;
         }
     }
 }
@@ -313,6 +447,12 @@ void place_tiles(const double* cursor_pos, vec2s win_size) {
         return;
     }
 
+    if (show_stats_panel_ &&
+        (cursor_pos[0] >= stats_panel_->pos.x && cursor_pos[0] <= stats_panel_->pos.x + stats_panel_->size.x) &&
+        (cursor_pos[1] >= stats_panel_->pos.y && cursor_pos[1] <= stats_panel_->pos.y + stats_panel_->size.y)) {
+        return;
+    }
+
     // Mouse button
     MouseButtonAction action_place  = engine_input_get_mouse_button(0);
     MouseButtonAction action_remove = engine_input_get_mouse_button(1);
@@ -332,95 +472,98 @@ void place_tiles(const double* cursor_pos, vec2s win_size) {
         remove = true;
     }
 
-    int32_t x = ((int)cursor_pos[0] + camera_.position.x) / tile_size_;
-    int32_t y = ((int)cursor_pos[1] + camera_.position.y) / tile_size_;
+    int32_t x = ((int)cursor_pos[0] + camera_.view.x) / tile_size_;
+    int32_t y = ((int)cursor_pos[1] + camera_.view.y) / tile_size_;
 
-    if ((x < 0 || x >= level_size_) || (y < 0 || y >= level_size_)) {
+    if ((x < 0 || x >= (int32_t) level_size_) || (y < 0 || y >= (int32_t) level_size_)) {
         return;
     }
 
     if (place) {
-        level_data_[(y * level_size_) + x] = tilepicker_->selected_tile;
+        game_level_set_tile(level_, x, y, tilepicker_->selected_tile);
     } else if (remove) {
-        level_data_[(y * level_size_) + x] = -1;
+        game_level_set_tile(level_, x, y, LEVEL_EMPTY_TILE);
     }
 }
 
-void render_tiles(Shader shader) {
-    
-    bool debug_draw = false;
-    if (!tilepicker_->tileset || !tilepicker_->show_tileset) {
-        debug_draw = true;
-    }
+// Draw state of render_tiles, handed to the level visitor
+typedef struct TileRenderState {
+    Shader shader;
+    vec2s render_size;
+    bool debug_draw;
+} TileRenderState;
+
+static void render_tile(int32_t x, int32_t y, int32_t tile, void* user) {
+    TileRenderState* state = (TileRenderState*) user;
 
     vec3s render_pos = (vec3s) {
-        0 - camera_.position.x, 
-        0 - camera_.position.y, 
+        (x * (float) tile_size_) - camera_.view.x,
+        (y * (float) tile_size_) - camera_.view.y,
         -1.0
     };
 
-    vec2s render_size = (vec2s) {
-        tile_size_,
-        tile_size_
-    };
+    engine_shader_bind(state->shader);
 
-    for (int32_t y = 0; y < level_size_; ++y) {
+    if (state->debug_draw || tile > tilepicker_->max_index) {
+        engine_shader_vec4(state->shader, "u_color", (vec4) {1.0, 0.0, 1.0, 1.0});
 
-        render_pos.x = 0 - camera_.position.x;
+        engine_render_quad(
+            NULL, 
+            NULL, 
+            render_pos.raw, 
+            state->render_size.raw
+        );
+    } else {
+        engine_shader_vec4(state->shader, "u_color", (vec4) {1.0, 1.0, 1.0, 1.0});
 
-        for (int32_t x = 0; x < level_size_; ++x) {
+        engine_render_quad(
+            tilepicker_->tileset, 
+            VECTOR_GET(&tilepicker_->tiles, tile).source.raw, 
+            render_pos.raw, 
+            state->render_size.raw
+        );
+    }
 
-            int32_t current = level_data_[(y * level_size_) + x];
-            if (current == -1) {
-                render_pos.x += tile_size_;
+    engine_shader_unbind(state->shader);
+}
 
-                continue;
-            }
+void render_tiles(Shader shader) {
 
-            engine_shader_bind(shader);
- 
-            if (debug_draw || current > tilepicker_->max_index) {
-                engine_shader_vec4(shader, "u_color", (vec4) {1.0, 0.0, 1.0, 1.0});
-
-                engine_render_quad(
-                    NULL, 
-                    NULL, 
-                    render_pos.raw, 
-                    render_size.raw
-                );
-            } else {
-                engine_shader_vec4(shader, "u_color", (vec4) {1.0, 1.0, 1.0, 1.0});
-
-                engine_render_quad(
-                    tilepicker_->tileset, 
-                    LIST_GET(tilepicker_->tiles, current).source.raw, 
-                    render_pos.raw, 
-                    render_size.raw
-                );
-            }
+    TileRenderState state = (TileRenderState) {
+        .shader = shader,
+        .render_size = (vec2s) {
+            tile_size_,
+            tile_size_
+        },
+        .debug_draw = !tilepicker_->tileset || !tilepicker_->show_tileset,
+    };
 
-            engine_shader_unbind(shader);
+    // Visible cell range
+    vec2s win_size = engine_window_get_size();
 
-            render_pos.x += tile_size_;
-        }
+    LevelBounds view = (LevelBounds) {
+        .min_x = (int32_t) (camera_.view.x / tile_size_),
+        .min_y = (int32_t) (camera_.view.y / tile_size_),
+        .max_x = (int32_t) ((camera_.view.x + win_size.x) / tile_size_),
+        .max_y = (int32_t) ((camera_.view.y + win_size.y) / tile_size_),
+    };
 
-        render_pos.y += tile_size_;
-    }
+    game_level_visit(level_, view, render_tile, &state);
 }
 
 void update_camera(double delta_time) {
 
-    GLFWwindow* window = engine_glfw_window();
+    camera_.previous = camera_.position;
 
-    if (glfwGetKey(window, GLFW_KEY_A)) {
+    if (engine_input_key_down(GLFW_KEY_A)) {
         camera_.position.x -= camera_speed_ * delta_time;
-    } else if (glfwGetKey(window, GLFW_KEY_D)) {
+    } else if (engine_input_key_down(GLFW_KEY_D)) {
         camera_.position.x += camera_speed_ * delta_time;
     }
     
-    if (glfwGetKey(window, GLFW_KEY_S)) {
+    if (engine_input_key_down(GLFW_KEY_S)) {
         camera_.position.y -= camera_speed_ * delta_time;
-    } else if (glfwGetKey(window, GLFW_KEY_W)) {
+    } else if (engine_input_key_down(GLFW_KEY_W)) {
         camera_.position.y += camera_speed_ * delta_time;
     }
 
@@ -432,6 +575,99 @@ void update_camera(double delta_time) {
     }
 }
 
+void update_camera_view() {
+    camera_.view = glms_vec2_lerp(camera_.previous, camera_.position, engine_tick_alpha());
+
+    // Held keys don't send events, keep the frames coming while moving or still catching up
+    if (engine_input_key_down(GLFW_KEY_A) || engine_input_key_down(GLFW_KEY_D) || 
+        engine_input_key_down(GLFW_KEY_S) || engine_input_key_down(GLFW_KEY_W) || 
+        !glms_vec2_eqv(camera_.previous, camera_.position)) {
+        engine_request_redraw();
+    }
+}
+
+void create_stats_panel(vec2s win_size) {
+
+    stats_panel_ = ui_panel_new("Stats", (vec2s) {0, win_size.y - 200}, (vec2s) {200, 200});
+
+    stats_painted_node_ = ui_label_new("Painted:", (vec2s) {0, 0});
+    ui_panel_add_node(stats_panel_, stats_painted_node_);
+
+    stats_bounds_node_ = ui_label_new("Bounds:", (vec2s) {0, 0});
+    ui_panel_add_node(stats_panel_, stats_bounds_node_);
+
+    stats_unique_node_ = ui_label_new("Unique tiles:", (vec2s) {0, 0});
+    ui_panel_add_node(stats_panel_, stats_unique_node_);
+
+    stats_selected_node_ = ui_label_new("Selected:", (vec2s) {0, 0});
+    ui_panel_add_node(stats_panel_, stats_selected_node_);
+
+    for (uint32_t i = 0; i < LEVEL_TOP_TILES; ++i) {
+        stats_top_nodes_[i] = ui_label_new("-", (vec2s) {0, 0});
+        ui_panel_add_node(stats_panel_, stats_top_nodes_[i]);
+    }
+
+    // Force the first refresh
+    stats_version_ = level_->stats.version - 1;
+    stats_selected_ = tilepicker_->selected_tile;
+}
+
+void update_stats_panel() {
+
+    // Counters are maintained on write, the labels only change with the level
+    if (level_->stats.version == stats_version_ && tilepicker_->selected_tile == stats_selected_) {
+        return;
+    }
+    stats_version_ = level_->stats.version;
+    stats_selected_ = tilepicker_->selected_tile;
+
+    const LevelStats* stats = &level_->stats;
+    char buffer[64];
+
+    snprintf(
+        buffer, sizeof(buffer), "Painted: %" PRIu64 " (%.2f%%)", 
+        stats->painted, game_level_painted_fraction(level_) * 100.0
+    );
+    ui_label_set_text(stats_painted_node_, buffer);
+
+    LevelBounds bounds;
+    if (game_level_bounds(level_, &bounds)) {
+        snprintf(
+            buffer, sizeof(buffer), "Bounds: %d,%d - %d,%d", 
+            bounds.min_x, bounds.min_y, bounds.max_x, bounds.max_y
+        );
+    } else {
+        snprintf(buffer, sizeof(buffer), "Bounds: -");
+    }
+    ui_label_set_text(stats_bounds_node_, buffer);
+
+    snprintf(buffer, sizeof(buffer), "Unique tiles: %u", stats->unique_tiles);
+    ui_label_set_text(stats_unique_node_, buffer);
+
+    if (tilepicker_->selected_tile >= 0) {
+        snprintf(
+            buffer, sizeof(buffer), "Selected #%d: %u", 
+            tilepicker_->selected_tile, game_level_tile_count(level_, tilepicker_->selected_tile)
+        );
+    } else {
+        snprintf(buffer, sizeof(buffer), "Selected: -");
+    }
+    ui_label_set_text(stats_selected_node_, buffer);
+
+    // Most used tiles, ranked by the level as it counts
+    int32_t top[LEVEL_TOP_TILES];
+    uint32_t top_count = game_level_top_tiles(level_, top);
+
+    for (uint32_t i = 0; i < LEVEL_TOP_TILES; ++i) {
+        if (i >= top_count) {
+            snprintf(buffer, sizeof(buffer), "-");
+        } else {
+            snprintf(buffer, sizeof(buffer), "#%d: %u", top[i], stats->tile_counts[top[i]]);
+        }
+        ui_label_set_text(stats_top_nodes_[i], buffer);
+    }
+}
+
 // Load
 void game_scene_menu_load() {
     scene_id_ = game_scene_get_new_id();
@@ -470,27 +706,18 @@ int32_t game_scene_menu() {
     double fps_timer = 3.0;
     vec2s fps_size = engine_font_get_text_size(default_font_, "0000", (engine_window_get_retina()) ? 0.25 : 1.0);
 
-    // Parse level settings
-    Map* config = parser_parse_yaml("config.yaml");
+    // Level settings
+    const EngineSettings* settings = engine_settings_get();
 
-    level_size_ = parser_yaml_parse_int(config, "level-size");
-    if (!level_size_) {
-        level_size_ = DEFAULT_LEVEL_SIZE;
-    }
+    level_size_ = settings->level_size;
+    settings_version_ = settings->version;
     printf("INFO: Level size is set to '%dx%d'.\n", level_size_, level_size_);
 
-    tile_size_  = parser_yaml_parse_int(config, "tile-size");
-    if (!tile_size_) {
-        tile_size_ = DEFAULT_TILE_SIZE;
-    }
+    tile_size_  = settings->tile_size;
     printf("INFO: Tile size is set to '%dx%d'.\n", tile_size_, tile_size_);
 
     // Level
-    size_t level_size = level_size_ * level_size_;
-    level_data_ = (int32_t*) malloc(sizeof(int32_t) * level_size);
-    for (uint32_t i = 0; i < level_size; ++i) {
-        level_data_[i] = -1;
-    }
+    level_ = game_level_new(level_size_);
 
     // Camera
     camera_ = (Camera) {
@@ -527,6 +754,16 @@ int32_t game_scene_menu() {
     UINode* clear_button = ui_button_new("Clear", (vec2s) {0, 0}, clear_map);
     ui_panel_add_node(panel, clear_button);
 
+    UINode* solid_tiles_label = ui_label_new("Solid tiles:", (vec2s) {0, 0});
+    ui_panel_add_node(panel, solid_tiles_label);
+
+    solid_tiles_node = ui_input_new("0,4,10-20", (vec2s) {0, 0});
+    ui_panel_add_node(panel, solid_tiles_node);
+    solid_tiles_node->size.x = 250 - (filename->rel_pos.x * 2);
+
+    UINode* collision_button = ui_button_new("Collision", (vec2s) {0, 0}, export_collision);
+    ui_panel_add_node(panel, collision_button);
+
     UINode* tileset_label = ui_label_new("Tileset", (vec2s) {0, 0});
     ui_panel_add_node(panel, tileset_label);
     
@@ -598,7 +835,10 @@ int32_t game_scene_menu() {
         .total_height = 0,
         .selected_tile = -1,
     };
-    tilepicker_->tiles = LIST_NEW(tilepicker_->tiles, Tile);
+    VECTOR_INIT(&tilepicker_->tiles, NULL);
+
+    // Stats panel
+    create_stats_panel(win_size);
 
     // Loop
     while(active_scene == scene_id_ && !glfwWindowShouldClose(window)) {
@@ -616,15 +856,15 @@ int32_t game_scene_menu() {
             fps_timer = 0.0;
         }
 
-        LIST_TYPE(KeyAction) keys_pressed = engine_input_get_keys_pressed();
+        const VECTOR(KeyAction)* keys_pressed = engine_input_get_keys_pressed();
         const double* scroll_input = engine_input_get_mouse_scroll();
         const double* cursor_pos   = engine_input_get_cursor_pos();
 
         Shader quad_shader = engine_renderer_quad_shader();
 
         // EVENT
-        for (int32_t i = 0; i < keys_pressed->count; ++i) {
-            KeyAction key = LIST_GET(keys_pressed, 0);
+        for (uint32_t i = 0; i < keys_pressed->count; ++i) {
+            KeyAction key = VECTOR_GET(keys_pressed, i);
 
             if (key.key == GLFW_KEY_ESCAPE && key.state == INPUT_KEY_PRESS) {
                 if (!show_exit_panel_) {
@@ -634,32 +874,89 @@ int32_t game_scene_menu() {
                     close_exit_panel();
                 }
             }
+
+            if (key.key == GLFW_KEY_F1 && key.state == INPUT_KEY_PRESS) {
+                show_stats_panel_ = !show_stats_panel_;
+            }
+
+            if (key.key == GLFW_KEY_F3 && key.state == INPUT_KEY_PRESS) {
+                engine_overlay_toggle();
+            }
+
+            // Start a trace of the next frames, or cut the running one short
+            if (key.key == GLFW_KEY_F4 && key.state == INPUT_KEY_PRESS) {
+                if (engine_trace_recording()) {
+                    engine_trace_stop();
+                } else {
+                    engine_trace_start(TRACE_DEFAULT_PATH, TRACE_DEFAULT_FRAMES);
+                }
+            }
         }
 
         // UPDATE
+        engine_profiler_begin("update");
+
+        apply_reloads();
+
+        engine_profiler_begin("update_tilepicker");
         update_tilepicker(scroll_input, cursor_pos);
+        engine_profiler_end();
+
+        // Fixed rate, the camera moves the same for the same elapsed time at any frame rate
+        engine_profiler_begin("ticks");
+        while (engine_tick()) {
+            update_camera(engine_tick_delta());
+        }
+        engine_profiler_end();
 
-        update_camera(delta_time);
+        update_camera_view();
 
+        engine_profiler_begin("place_tiles");
         place_tiles(cursor_pos, win_size);
+        engine_profiler_end();
+
+        engine_profiler_end();
 
         // RENDER
+        engine_profiler_begin("render");
+
         glClearColor(0.06, 0.05, 0.11, 1.0);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         // Render tiles
+        engine_profiler_begin("render_tiles");
+        engine_profiler_gpu_begin("tiles");
+        engine_renderer_set_category(RENDER_CATEGORY_TILES);
         render_tiles(quad_shader);
+        engine_profiler_gpu_end();
+        engine_profiler_end();
 
         // Update the panel
+        engine_profiler_gpu_begin("ui");
+        engine_profiler_begin("ui_panel_update");
+        engine_renderer_set_category(RENDER_CATEGORY_UI);
         ui_panel_update(panel);
+        engine_profiler_end();
 
         // Draw the tilepicker
+        engine_profiler_begin("render_tilepicker");
+        engine_renderer_set_category(RENDER_CATEGORY_TILEPICKER);
         render_tilepicker(quad_shader);
+        engine_renderer_set_category(RENDER_CATEGORY_UI);
+        engine_profiler_end();
+
+        // Draw the stats panel
+        if (show_stats_panel_) {
+            update_stats_panel();
+            ui_panel_update(stats_panel_);
+        }
 
         // Draw the exit panel
         if (show_exit_panel_) {
             ui_panel_update(exit_panel);
         }
+        engine_profiler_gpu_end();
+        engine_renderer_set_category(RENDER_CATEGORY_OTHER);
 
         // Render fps
         engine_render_text(
@@ -668,7 +965,21 @@ int32_t game_scene_menu() {
             fps_buffer, COLOR_WHITE, (engine_window_get_retina()) ? 0.25 : 1.0
         );
 
-        glfwSwapBuffers(window);
+        // Render the debug overlay under the fps
+        if (engine_overlay_visible()) {
+            engine_overlay_render(
+                default_font_, 
+                (vec2s) {5, win_size.y - 10 - fps_size.y}, 
+                (engine_window_get_retina()) ? 0.25 : 1.0
+            );
+        }
+
+        engine_profiler_end();
+
+        engine_profiler_begin("swap");
+        engine_swap_buffers();
+        engine_profiler_end();
+
         engine_poll_events();
 
         // Check the active scene
@@ -679,16 +990,17 @@ int32_t game_scene_menu() {
     ui_free();
 
     ui_node_free(panel);
+    ui_node_free(stats_panel_);
 
     // Free tilepicker
     if (tilepicker_->tileset) {
         engine_texture_free(tilepicker_->tileset);
     }
-    LIST_FREE(tilepicker_->tiles);
+    VECTOR_FREE(&tilepicker_->tiles);
     free(tilepicker_);
 
     // Free level
-    free(level_data_);
+    game_level_free(level_);
 
     return SCENE_EXECUTED;
 }
\ No newline at end of file
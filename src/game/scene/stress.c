@@ -0,0 +1,341 @@
+#include "stress.h"
+
+#include "game/level.h"
+
+#include "game/ui/ui.h"
+#include "game/ui/label.h"
+#include "game/ui/panel.h"
+
+#include "engine/engine.h"
+#include "engine/window.h"
+#include "engine/renderer.h"
+#include "engine/font.h"
+#include "engine/settings.h"
+#include "engine/profiler.h"
+#include "engine/pacing.h"
+
+
+// Add scene definitions
+SCENE_DEFINE(stress);
+
+// Defines
+#define STRESS_TILE_IDS         256
+#define STRESS_LABEL_COUNT      4096
+#define STRESS_LABEL_COLUMNS    32
+#define STRESS_LIVE_LABELS      256 // Labels whose text changes every frame
+#define STRESS_TEXT_LENGTH      4096
+#define STRESS_WARMUP_FRAMES    30
+
+// Configuration
+static uint32_t level_size_ = STRESS_DEFAULT_LEVEL_SIZE;
+static uint32_t frame_count_ = STRESS_DEFAULT_FRAMES;
+static uint32_t tile_size_;
+
+// Resources
+static Font* default_font_;
+
+// Tile colors, one per tile id
+static vec4s tile_colors_[STRESS_TILE_IDS];
+
+// Static
+typedef struct StressTileState {
+    Shader shader;
+    vec2s camera;
+    vec2s render_size;
+} StressTileState;
+
+static void stress_render_tile(int32_t x, int32_t y, int32_t tile, void* user) {
+    StressTileState* state = (StressTileState*) user;
+
+    vec3s render_pos = (vec3s) {
+        (x * (float) tile_size_) - state->camera.x,
+        (y * (float) tile_size_) - state->camera.y,
+        -1.0
+    };
+
+    engine_shader_bind(state->shader);
+    engine_shader_vec4(state->shader, "u_color", tile_colors_[tile % STRESS_TILE_IDS].raw);
+
+    engine_render_quad(NULL, NULL, render_pos.raw, state->render_size.raw);
+
+    engine_shader_unbind(state->shader);
+}
+
+// Every cell painted with a random id, seeded so every run draws the same frames
+static Level* stress_generate_level() {
+
+    Level* level = game_level_new(level_size_);
+    if (!level) {
+        return NULL;
+    }
+
+    uint32_t state = 0x9e3779b9;
+    size_t cells = (size_t) level_size_ * level_size_;
+
+    for (size_t i = 0; i < cells; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        level->data[i] = state % STRESS_TILE_IDS;
+    }
+
+    game_level_recalculate_stats(level);
+
+    return level;
+}
+
+// Figure of eight over the whole level, a function of the frame only
+static vec2s stress_camera_position(uint32_t frame, vec2s win_size) {
+
+    double t = (double) frame / frame_count_ * 2.0 * M_PI;
+    double extent = (double) level_size_ * tile_size_;
+
+    return (vec2s) {
+        (float) ((0.5 + 0.45 * sin(t)) * extent - win_size.x * 0.5),
+        (float) ((0.5 + 0.45 * sin(t * 2.0)) * extent - win_size.y * 0.5),
+    };
+}
+
+static int stress_compare(const void* a, const void* b) {
+    double lhs = *(const double*) a;
+    double rhs = *(const double*) b;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static void stress_print_results(double* frame_times, uint32_t count, double elapsed) {
+
+    if (!count) {
+        printf("ERROR: Stress test ended before any frame was measured.\n");
+        return;
+    }
+
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum += frame_times[i];
+    }
+
+    qsort(frame_times, count, sizeof(double), stress_compare);
+
+    RenderCounters counters = engine_renderer_counters_total();
+
+    printf("INFO: Stress test, level %ux%u, %u frames (%u warm-up) in %.2f s.\n", level_size_, level_size_, count, STRESS_WARMUP_FRAMES, elapsed);
+    printf(
+        "INFO: Frame time avg %.3f ms, p50 %.3f, p95 %.3f, p99 %.3f, max %.3f (%.1f fps).\n",
+        sum / count, frame_times[count / 2], frame_times[(uint32_t) (count * 0.95)], frame_times[(uint32_t) (count * 0.99)],
+        frame_times[count - 1], 1000.0 * count / sum
+    );
+    printf(
+        "INFO: Last frame %u draw calls, %u texture binds, %u program binds, %u uniform uploads.\n",
+        counters.draw_calls, counters.texture_binds, counters.program_binds, counters.uniform_uploads
+    );
+}
+
+// Set
+void game_scene_stress_configure(uint32_t level_size, uint32_t frames) {
+    level_size_ = (level_size) ? level_size : STRESS_DEFAULT_LEVEL_SIZE;
+    frame_count_ = (frames) ? frames : STRESS_DEFAULT_FRAMES;
+}
+
+// Load
+void game_scene_stress_load() {
+    scene_id_ = game_scene_get_new_id();
+
+    uint32_t font_size = (engine_window_get_retina()) ? FONT_DEFAULT_PIXEL_SIZE : 12;
+
+    default_font_ = engine_font_new(
+        "res/font/FiraMono-Regular.ttf", 
+        font_size, 
+        GL_LINEAR
+    );
+
+    for (uint32_t i = 0; i < STRESS_TILE_IDS; ++i) {
+        tile_colors_[i] = (vec4s) {
+            0.3f + 0.7f * ((i * 37) % 256) / 255.0f,
+            0.3f + 0.7f * ((i * 91) % 256) / 255.0f,
+            0.3f + 0.7f * ((i * 173) % 256) / 255.0f,
+            1.0f
+        };
+    }
+}
+
+// Free
+void game_scene_stress_free() {
+
+    engine_font_free(default_font_);
+}
+
+// Main
+int32_t game_scene_stress() {
+
+    // Get the active scene
+    uint32_t active_scene = game_scene_get_active_scene();
+
+    if (active_scene != scene_id_) {
+        return SCENE_SKIPPED;
+    }
+
+    // Setup
+    GLFWwindow* window = engine_glfw_window();
+    vec2s win_size = engine_window_get_size();
+    float text_scale = (engine_window_get_retina()) ? 0.25 : 1.0;
+
+    tile_size_ = engine_settings_get()->tile_size;
+
+    printf("INFO: Generating a %ux%u stress level.\n", level_size_, level_size_);
+
+    Level* level = stress_generate_level();
+    if (!level) {
+        glfwSetWindowShouldClose(window, true);
+        return SCENE_EXECUTED;
+    }
+
+    // UI, a grid of labels over the screen and a panel on top
+    ui_init();
+
+    UINode* labels = ui_node_new((vec2s) {0, 0}, win_size);
+
+    char buffer[64];
+    for (uint32_t i = 0; i < STRESS_LABEL_COUNT; ++i) {
+        vec2s pos = (vec2s) {
+            (i % STRESS_LABEL_COLUMNS) * (win_size.x / STRESS_LABEL_COLUMNS),
+            (i / STRESS_LABEL_COLUMNS) * (win_size.y / (STRESS_LABEL_COUNT / STRESS_LABEL_COLUMNS)),
+        };
+
+        snprintf(buffer, sizeof(buffer), "label %u", i);
+
+        UINode* label = ui_label_new(buffer, (vec2s) {0, 0});
+        label->parent = labels;
+        VECTOR_PUSH(&labels->children, label);
+
+        ui_node_set_position(label, pos);
+    }
+
+    UINode* panel = ui_panel_new("Stress", (vec2s) {win_size.x - 250, 0}, (vec2s) {250, win_size.y});
+
+    UINode* frame_label = ui_label_new("Frame", (vec2s) {0, 0});
+    ui_panel_add_node(panel, frame_label);
+
+    // Long text, wrapped by nothing so most of it runs off screen like a real overflow
+    char* text = (char*) malloc(STRESS_TEXT_LENGTH + 1);
+    for (uint32_t i = 0; i < STRESS_TEXT_LENGTH; ++i) {
+        text[i] = (i % 64 == 63) ? ' ' : 'a' + (i * 7) % 26;
+    }
+    text[STRESS_TEXT_LENGTH] = '\0';
+
+    Shader quad_shader = engine_renderer_quad_shader();
+
+    StressTileState tile_state = (StressTileState) {
+        .shader = quad_shader,
+        .render_size = (vec2s) { tile_size_, tile_size_ },
+    };
+
+    double* frame_times = (double*) malloc(sizeof(double) * frame_count_);
+    uint32_t measured = 0;
+
+    // Measures what a frame costs, not the frame cap
+    engine_pacing_set_target(0);
+
+    double start = glfwGetTime();
+    double frame_start = start;
+
+    // Loop
+    for (uint32_t frame = 0; frame < frame_count_ && active_scene == scene_id_ && !glfwWindowShouldClose(window); ++frame) {
+
+        engine_calculate_delta_time();
+        engine_calculate_fps();
+
+        // UPDATE
+        engine_profiler_begin("update");
+
+        tile_state.camera = stress_camera_position(frame, win_size);
+
+        for (uint32_t i = 0; i < STRESS_LIVE_LABELS; ++i) {
+            snprintf(buffer, sizeof(buffer), "%u:%u", i, frame);
+            ui_label_set_text(VECTOR_GET(&labels->children, (i * 16 + frame) % STRESS_LABEL_COUNT), buffer);
+        }
+
+        snprintf(buffer, sizeof(buffer), "Frame %u/%u", frame + 1, frame_count_);
+        ui_label_set_text(frame_label, buffer);
+
+        engine_profiler_end();
+
+        // RENDER
+        engine_profiler_begin("render");
+
+        glClearColor(0.06, 0.05, 0.11, 1.0);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Tiles, the whole view is painted
+        engine_profiler_begin("render_tiles");
+        engine_profiler_gpu_begin("tiles");
+        engine_renderer_set_category(RENDER_CATEGORY_TILES);
+
+        LevelBounds view = (LevelBounds) {
+            .min_x = (int32_t) floorf(tile_state.camera.x / tile_size_),
+            .min_y = (int32_t) floorf(tile_state.camera.y / tile_size_),
+            .max_x = (int32_t) ((tile_state.camera.x + win_size.x) / tile_size_),
+            .max_y = (int32_t) ((tile_state.camera.y + win_size.y) / tile_size_),
+        };
+        game_level_visit(level, view, stress_render_tile, &tile_state);
+
+        engine_profiler_gpu_end();
+        engine_profiler_end();
+
+        // UI
+        engine_profiler_begin("ui");
+        engine_profiler_gpu_begin("ui");
+        engine_renderer_set_category(RENDER_CATEGORY_UI);
+
+        for (uint32_t i = 0; i < labels->children.count; ++i) {
+            ui_label_update(VECTOR_GET(&labels->children, i));
+        }
+
+        ui_panel_update(panel);
+
+        engine_render_text(default_font_, (vec3) {5, win_size.y * 0.5f, -1.0}, text, COLOR_WHITE, text_scale);
+
+        engine_renderer_set_category(RENDER_CATEGORY_OTHER);
+        engine_profiler_gpu_end();
+        engine_profiler_end();
+
+        engine_profiler_end();
+
+        engine_profiler_begin("swap");
+        engine_swap_buffers();
+        engine_profiler_end();
+
+        // Measures the render loop, never idle
+        engine_request_redraw();
+        engine_poll_events();
+
+        // Whole frame, swap included
+        double now = glfwGetTime();
+        if (frame >= STRESS_WARMUP_FRAMES) {
+            frame_times[measured++] = (now - frame_start) * 1000.0;
+        }
+        frame_start = now;
+
+        // Check the active scene
+        active_scene = game_scene_get_active_scene();
+    }
+
+    stress_print_results(frame_times, measured, glfwGetTime() - start);
+
+    engine_pacing_set_target(PACING_FROM_SETTINGS);
+
+    // The load test is over
+    glfwSetWindowShouldClose(window, true);
+
+    free(frame_times);
+    free(text);
+
+    ui_node_free(labels);
+    ui_node_free(panel);
+
+    ui_free();
+
+    game_level_free(level);
+
+    return SCENE_EXECUTED;
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "util/common.h"
+
+#include "game/scene.h"
+
+// Defaults
+#define STRESS_DEFAULT_LEVEL_SIZE   4096
+#define STRESS_DEFAULT_FRAMES       600
+
+// Add scene declerations
+SCENE_DECLARE(stress);
+
+// Set, before the scene runs
+void game_scene_stress_configure(uint32_t level_size, uint32_t frames);
\ No newline at end of file
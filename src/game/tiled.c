@@ -0,0 +1,1213 @@
+#define HEAP_TAG HEAP_TAG_LEVEL
+#include "tiled.h"
+
+#include "util/util.h"
+#include "util/file.h"
+#include "util/arena.h"
+
+#include <zlib.h>
+#include <unistd.h>
+
+
+// Defines
+#define TILED_CHUNK_SIZE    (64 * 1024)
+#define TILED_FIRST_GID     1
+#define TILED_LAYER_NAME    "Tile Layer 1"
+#define TILED_VERSION       "1.10"
+#define TILED_GID_MASK      0x0FFFFFFF // Strips the flip flags
+#define TILED_PATH_SIZE     4096
+
+// Streaming layer encoder, raw gids -> deflate -> base64 -> file
+typedef struct TiledWriter {
+    FILE* file;
+    int32_t compression;
+    z_stream stream;
+
+    uint8_t carry[3];
+    uint32_t carry_count;
+
+    uint8_t compressed[TILED_CHUNK_SIZE];
+    char encoded[(TILED_CHUNK_SIZE / 3 + 1) * 4];
+} TiledWriter;
+
+// Streaming layer decoder, file -> base64 -> inflate -> gids -> scratch cells
+typedef struct TiledReader {
+    Level* level;
+    int32_t* cells; // Same layout as the level's data, only swapped in once the import succeeded
+
+    uint32_t width;
+    uint32_t height;
+    uint32_t first_gid;
+    uint32_t csv_offset; // Added to csv values to turn them into gids
+
+    uint32_t x;
+    uint32_t row;
+
+    uint8_t carry[4];
+    uint32_t carry_count;
+
+    bool compressed;
+    z_stream stream;
+
+    uint8_t decoded[TILED_CHUNK_SIZE];
+    uint8_t inflated[TILED_CHUNK_SIZE];
+} TiledReader;
+
+// Read only view into the mapped file, nothing is copied out of it
+typedef struct TiledSpan {
+    const char* start;
+    const char* end;
+} TiledSpan;
+
+// Tile layer fields gathered while scanning
+typedef struct TiledLayer {
+    uint32_t width;
+    uint32_t height;
+
+    TiledSpan encoding;
+    TiledSpan compression;
+    TiledSpan data;
+} TiledLayer;
+
+// Statics
+static const char base64_table_[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const char* compression_names_[] = { NULL, "zlib", "gzip" };
+
+// Static
+static void game_tiled_write_escaped(FILE* file, const char* text, int32_t format) {
+    for (const char* c = text; *c; ++c) {
+        if (format == TILED_FORMAT_TMX) {
+            switch (*c) {
+            case '&':  fputs("&amp;",  file); continue;
+            case '<':  fputs("&lt;",   file); continue;
+            case '>':  fputs("&gt;",   file); continue;
+            case '"':  fputs("&quot;", file); continue;
+            }
+
+            // Attributes keep whitespace only as character references, XML has no other control characters
+            if ((uint8_t) *c < 0x20) {
+                if (*c == '\t' || *c == '\n' || *c == '\r') {
+                    fprintf(file, "&#%d;", *c);
+                }
+                continue;
+            }
+        } else if (*c == '"' || *c == '\\') {
+            fputc('\\', file);
+        } else if ((uint8_t) *c < 0x20) {
+            switch (*c) {
+            case '\n': fputs("\\n", file); continue;
+            case '\r': fputs("\\r", file); continue;
+            case '\t': fputs("\\t", file); continue;
+            default:   fprintf(file, "\\u%04x", (uint8_t) *c); continue;
+            }
+        }
+
+        fputc(*c, file);
+    }
+}
+
+// Absolute path with the '.' and '..' components resolved, the file doesn't have to exist
+static bool game_tiled_absolute_path(const char* path, char* out, size_t size) {
+    char joined[TILED_PATH_SIZE];
+
+    if (path[0] == '/') {
+        if (snprintf(joined, sizeof(joined), "%s", path) >= (int) sizeof(joined)) {
+            return false;
+        }
+    } else {
+        char cwd[TILED_PATH_SIZE];
+        if (!getcwd(cwd, sizeof(cwd)) || snprintf(joined, sizeof(joined), "%s/%s", cwd, path) >= (int) sizeof(joined)) {
+            return false;
+        }
+    }
+
+    size_t len = 0;
+    for (char* part = strtok(joined, "/"); part; part = strtok(NULL, "/")) {
+        if (strcmp(part, ".") == STR_EQUAL) {
+            continue;
+        }
+
+        if (strcmp(part, "..") == STR_EQUAL) {
+            while (len > 0 && out[--len] != '/') {}
+            continue;
+        }
+
+        size_t part_len = strlen(part);
+        if (len + part_len + 2 > size) {
+            return false;
+        }
+
+        out[len++] = '/';
+        memcpy(out + len, part, part_len);
+        len += part_len;
+    }
+
+    if (len == 0) {
+        out[len++] = '/';
+    }
+    out[len] = '\0';
+
+    return true;
+}
+
+// Tiled resolves the tileset image against the map's directory, not the editor's
+static void game_tiled_relative_path(const char* target, const char* from_file, char* out, size_t size) {
+    char target_abs[TILED_PATH_SIZE];
+    char from_abs[TILED_PATH_SIZE];
+
+    if (!game_tiled_absolute_path(target, target_abs, sizeof(target_abs)) || 
+        !game_tiled_absolute_path(from_file, from_abs, sizeof(from_abs))) {
+        snprintf(out, size, "%s", target);
+        return;
+    }
+
+    // Directory of the map, keeps the leading slash
+    *(strrchr(from_abs, '/') + 1) = '\0';
+
+    // Shared leading directories
+    size_t common = 0;
+    for (size_t i = 0; target_abs[i] && target_abs[i] == from_abs[i]; ++i) {
+        if (target_abs[i] == '/') {
+            common = i + 1;
+        }
+    }
+
+    // One step up for every directory of the map past the shared ones
+    size_t len = 0;
+    for (const char* c = from_abs + common; *c; ++c) {
+        if (*c == '/' && len + 4 < size) {
+            memcpy(out + len, "../", 3);
+            len += 3;
+        }
+    }
+
+    snprintf(out + len, size - len, "%s", target_abs + common);
+}
+
+static void game_tiled_base64_write(TiledWriter* writer, const uint8_t* data, size_t len) {
+
+    const uint8_t* end = data + len;
+
+    // Complete the triplet left over from the previous call
+    while (writer->carry_count > 0 && writer->carry_count < 3 && data < end) {
+        writer->carry[writer->carry_count++] = *data++;
+    }
+
+    char* out = writer->encoded;
+
+    if (writer->carry_count == 3) {
+        const uint8_t* c = writer->carry;
+
+        *out++ = base64_table_[c[0] >> 2];
+        *out++ = base64_table_[((c[0] & 0x03) << 4) | (c[1] >> 4)];
+        *out++ = base64_table_[((c[1] & 0x0F) << 2) | (c[2] >> 6)];
+        *out++ = base64_table_[c[2] & 0x3F];
+
+        writer->carry_count = 0;
+    }
+
+    while (end - data >= 3) {
+
+        // Flush before the encoded buffer overflows
+        if ((size_t) (out - writer->encoded) >= sizeof(writer->encoded) - 4) {
+            fwrite(writer->encoded, 1, out - writer->encoded, writer->file);
+            out = writer->encoded;
+        }
+
+        *out++ = base64_table_[data[0] >> 2];
+        *out++ = base64_table_[((data[0] & 0x03) << 4) | (data[1] >> 4)];
+        *out++ = base64_table_[((data[1] & 0x0F) << 2) | (data[2] >> 6)];
+        *out++ = base64_table_[data[2] & 0x3F];
+
+        data += 3;
+    }
+
+    fwrite(writer->encoded, 1, out - writer->encoded, writer->file);
+
+    while (data < end) {
+        writer->carry[writer->carry_count++] = *data++;
+    }
+}
+
+static void game_tiled_base64_flush(TiledWriter* writer) {
+    if (writer->carry_count == 0) {
+        return;
+    }
+
+    const uint8_t* c = writer->carry;
+    char out[4];
+
+    out[0] = base64_table_[c[0] >> 2];
+    if (writer->carry_count == 1) {
+        out[1] = base64_table_[(c[0] & 0x03) << 4];
+        out[2] = '=';
+    } else {
+        out[1] = base64_table_[((c[0] & 0x03) << 4) | (c[1] >> 4)];
+        out[2] = base64_table_[(c[1] & 0x0F) << 2];
+    }
+    out[3] = '=';
+
+    fwrite(out, 1, 4, writer->file);
+    writer->carry_count = 0;
+}
+
+static bool game_tiled_layer_write(TiledWriter* writer, const uint8_t* data, size_t len, bool finish) {
+
+    if (writer->compression == TILED_COMPRESSION_NONE) {
+        game_tiled_base64_write(writer, data, len);
+        if (finish) {
+            game_tiled_base64_flush(writer);
+        }
+        return true;
+    }
+
+    z_stream* stream = &writer->stream;
+    stream->next_in  = (Bytef*) data;
+    stream->avail_in = (uInt) len;
+
+    int32_t flush = (finish) ? Z_FINISH : Z_NO_FLUSH;
+    int32_t result;
+
+    // Drain the compressor one chunk at a time
+    do {
+        stream->next_out  = writer->compressed;
+        stream->avail_out = TILED_CHUNK_SIZE;
+
+        result = deflate(stream, flush);
+        if (result == Z_STREAM_ERROR) {
+            printf("ERROR: Failed to compress layer data.\n");
+            return false;
+        }
+
+        game_tiled_base64_write(writer, writer->compressed, TILED_CHUNK_SIZE - stream->avail_out);
+    } while (stream->avail_out == 0 || (finish && result != Z_STREAM_END));
+
+    if (finish) {
+        game_tiled_base64_flush(writer);
+    }
+
+    return true;
+}
+
+static bool game_tiled_write_layer_data(TiledWriter* writer, Level* level) {
+
+    uint32_t size = level->size;
+    size_t row_bytes = (size_t) size * sizeof(uint32_t);
+
+    // Encode as many rows as fit in a chunk, but at least one
+    uint32_t rows_per_chunk = TILED_CHUNK_SIZE / row_bytes;
+    if (rows_per_chunk == 0) {
+        rows_per_chunk = 1;
+    }
+
+    Arena* scratch = arena_scratch();
+    ArenaMark mark = arena_mark(scratch);
+
+    uint8_t* chunk = ARENA_ALLOC(scratch, uint8_t, row_bytes * rows_per_chunk);
+    bool success = true;
+
+    // Tiled stores rows top to bottom, the level stores them bottom to top
+    for (uint32_t row = 0; row < size && success; row += rows_per_chunk) {
+
+        uint32_t rows = (size - row < rows_per_chunk) ? size - row : rows_per_chunk;
+        uint8_t* out = chunk;
+
+        for (uint32_t r = row; r < row + rows; ++r) {
+            uint32_t y = size - 1 - r;
+            const int32_t* cells = level->data + (size_t) y * size;
+
+            for (uint32_t chunk_x = 0; chunk_x < level->chunks_per_row; ++chunk_x) {
+
+                uint32_t start = chunk_x * LEVEL_CHUNK_SIZE;
+                uint32_t end = (start + LEVEL_CHUNK_SIZE < size) ? start + LEVEL_CHUNK_SIZE : size;
+
+                // Empty runs are all zero gids
+                if (game_level_occupancy(level, chunk_x, y) == 0) {
+                    memset(out, 0, (end - start) * sizeof(uint32_t));
+                    out += (end - start) * sizeof(uint32_t);
+                    continue;
+                }
+
+                // Little endian global tile ids, 0 is empty
+                for (uint32_t x = start; x < end; ++x) {
+                    uint32_t gid = (cells[x] < 0) ? 0 : (uint32_t) cells[x] + TILED_FIRST_GID;
+
+                    out[0] = (uint8_t) (gid);
+                    out[1] = (uint8_t) (gid >> 8);
+                    out[2] = (uint8_t) (gid >> 16);
+                    out[3] = (uint8_t) (gid >> 24);
+                    out += 4;
+                }
+            }
+        }
+
+        success = game_tiled_layer_write(writer, chunk, out - chunk, row + rows == size);
+    }
+
+    arena_restore(scratch, mark);
+
+    return success;
+}
+
+static void game_tiled_write_tmx_header(FILE* file, Level* level, int32_t compression, const TiledTileset* tileset, uint32_t tile_width, uint32_t tile_height) {
+
+    fprintf(file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    fprintf(
+        file,
+        "<map version=\"" TILED_VERSION "\" orientation=\"orthogonal\" renderorder=\"right-down\" "
+        "width=\"%u\" height=\"%u\" tilewidth=\"%u\" tileheight=\"%u\" infinite=\"0\" nextlayerid=\"2\" nextobjectid=\"1\">\n",
+        level->size, level->size, tile_width, tile_height
+    );
+
+    if (tileset && tileset->image) {
+        uint32_t columns = tileset->image_width / tile_width;
+        uint32_t count = columns * (tileset->image_height / tile_height);
+
+        fprintf(
+            file, " <tileset firstgid=\"%d\" name=\"tileset\" tilewidth=\"%u\" tileheight=\"%u\" tilecount=\"%u\" columns=\"%u\">\n",
+            TILED_FIRST_GID, tile_width, tile_height, count, columns
+        );
+        fprintf(file, "  <image source=\"");
+        game_tiled_write_escaped(file, tileset->image, TILED_FORMAT_TMX);
+        fprintf(file, "\" width=\"%u\" height=\"%u\"/>\n", tileset->image_width, tileset->image_height);
+        fprintf(file, " </tileset>\n");
+    }
+
+    fprintf(file, " <layer id=\"1\" name=\"" TILED_LAYER_NAME "\" width=\"%u\" height=\"%u\">\n", level->size, level->size);
+
+    if (compression == TILED_COMPRESSION_NONE) {
+        fprintf(file, "  <data encoding=\"base64\">\n   ");
+    } else {
+        fprintf(file, "  <data encoding=\"base64\" compression=\"%s\">\n   ", compression_names_[compression]);
+    }
+}
+
+static void game_tiled_write_tmx_footer(FILE* file) {
+    fprintf(file, "\n  </data>\n </layer>\n</map>\n");
+}
+
+static void game_tiled_write_json_header(FILE* file, Level* level, int32_t compression, const TiledTileset* tileset, uint32_t tile_width, uint32_t tile_height) {
+
+    fprintf(
+        file,
+        "{\"type\":\"map\",\"version\":\"" TILED_VERSION "\",\"orientation\":\"orthogonal\",\"renderorder\":\"right-down\","
+        "\"width\":%u,\"height\":%u,\"tilewidth\":%u,\"tileheight\":%u,\"infinite\":false,\"nextlayerid\":2,\"nextobjectid\":1,\n",
+        level->size, level->size, tile_width, tile_height
+    );
+
+    fprintf(file, "\"tilesets\":[");
+    if (tileset && tileset->image) {
+        uint32_t columns = tileset->image_width / tile_width;
+        uint32_t count = columns * (tileset->image_height / tile_height);
+
+        fprintf(file, "{\"firstgid\":%d,\"name\":\"tileset\",\"image\":\"", TILED_FIRST_GID);
+        game_tiled_write_escaped(file, tileset->image, TILED_FORMAT_JSON);
+        fprintf(
+            file, "\",\"imagewidth\":%u,\"imageheight\":%u,\"tilewidth\":%u,\"tileheight\":%u,\"tilecount\":%u,\"columns\":%u,\"margin\":0,\"spacing\":0}",
+            tileset->image_width, tileset->image_height, tile_width, tile_height, count, columns
+        );
+    }
+    fprintf(file, "],\n");
+
+    fprintf(
+        file,
+        "\"layers\":[{\"id\":1,\"name\":\"" TILED_LAYER_NAME "\",\"type\":\"tilelayer\",\"x\":0,\"y\":0,"
+        "\"width\":%u,\"height\":%u,\"opacity\":1,\"visible\":true,\"encoding\":\"base64\",",
+        level->size, level->size
+    );
+
+    if (compression != TILED_COMPRESSION_NONE) {
+        fprintf(file, "\"compression\":\"%s\",", compression_names_[compression]);
+    }
+
+    fprintf(file, "\n\"data\":\"");
+}
+
+static void game_tiled_write_json_footer(FILE* file) {
+    fprintf(file, "\"}]}\n");
+}
+
+static void game_tiled_write_csv(FILE* file, Level* level) {
+
+    uint32_t size = level->size;
+
+    // Widest row is 12 characters per value
+    Arena* scratch = arena_scratch();
+    ArenaMark mark = arena_mark(scratch);
+
+    char* line = ARENA_ALLOC(scratch, char, (size_t) size * 12 + 2);
+
+    for (uint32_t row = 0; row < size; ++row) {
+        const int32_t* cells = level->data + (size_t) (size - 1 - row) * size;
+        char* out = line;
+
+        for (uint32_t x = 0; x < size; ++x) {
+            int32_t value = cells[x];
+
+            if (value < 0) {
+                *out++ = '-';
+                *out++ = '1';
+            } else {
+                char digits[10];
+                int32_t count = 0;
+
+                do {
+                    digits[count++] = '0' + (value % 10);
+                    value /= 10;
+                } while (value);
+
+                while (count) {
+                    *out++ = digits[--count];
+                }
+            }
+
+            *out++ = (x == size - 1) ? '\n' : ',';
+        }
+
+        fwrite(line, 1, out - line, file);
+    }
+
+    arena_restore(scratch, mark);
+}
+
+// Import helpers
+static bool game_tiled_span_equals(TiledSpan span, const char* text) {
+    size_t len = strlen(text);
+    return (size_t) (span.end - span.start) == len && memcmp(span.start, text, len) == STR_EQUAL;
+}
+
+static uint32_t game_tiled_span_uint(TiledSpan span) {
+    uint32_t value = 0;
+    for (const char* c = span.start; c < span.end && *c >= '0' && *c <= '9'; ++c) {
+        value = value * 10 + (*c - '0');
+    }
+    return value;
+}
+
+static const char* game_tiled_find(const char* start, const char* end, const char* needle) {
+    size_t len = strlen(needle);
+
+    for (const char* c = start; c + len <= end; ++c) {
+        c = memchr(c, needle[0], end - c);
+        if (!c || c + len > end) {
+            return NULL;
+        }
+        if (memcmp(c, needle, len) == STR_EQUAL) {
+            return c;
+        }
+    }
+
+    return NULL;
+}
+
+static void game_tiled_reader_put(TiledReader* reader, uint32_t gid) {
+    if (reader->row >= reader->height) {
+        return;
+    }
+
+    Level* level = reader->level;
+
+    // Tiled rows go top to bottom, the level's go bottom to top
+    uint32_t y = reader->height - 1 - reader->row;
+    if (reader->x < level->size && y < level->size) {
+        gid &= TILED_GID_MASK;
+        reader->cells[(size_t) y * level->size + reader->x] = (gid < reader->first_gid) ? LEVEL_EMPTY_TILE : (int32_t) (gid - reader->first_gid);
+    }
+
+    if (++reader->x == reader->width) {
+        reader->x = 0;
+        reader->row++;
+    }
+}
+
+static void game_tiled_reader_put_bytes(TiledReader* reader, const uint8_t* data, size_t len) {
+
+    const uint8_t* end = data + len;
+
+    // Complete a gid split across chunks
+    while (reader->carry_count > 0 && data < end) {
+        reader->carry[reader->carry_count++] = *data++;
+
+        if (reader->carry_count == 4) {
+            const uint8_t* c = reader->carry;
+            game_tiled_reader_put(reader, c[0] | (c[1] << 8) | (c[2] << 16) | ((uint32_t) c[3] << 24));
+            reader->carry_count = 0;
+        }
+    }
+
+    for (; end - data >= 4; data += 4) {
+        game_tiled_reader_put(reader, data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t) data[3] << 24));
+    }
+
+    while (data < end) {
+        reader->carry[reader->carry_count++] = *data++;
+    }
+}
+
+static bool game_tiled_reader_put_decoded(TiledReader* reader, const uint8_t* data, size_t len) {
+
+    if (!reader->compressed) {
+        game_tiled_reader_put_bytes(reader, data, len);
+        return true;
+    }
+
+    z_stream* stream = &reader->stream;
+    stream->next_in  = (Bytef*) data;
+    stream->avail_in = (uInt) len;
+
+    do {
+        stream->next_out  = reader->inflated;
+        stream->avail_out = TILED_CHUNK_SIZE;
+
+        int32_t result = inflate(stream, Z_NO_FLUSH);
+        if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+            printf("ERROR: Failed to decompress layer data.\n");
+            return false;
+        }
+
+        game_tiled_reader_put_bytes(reader, reader->inflated, TILED_CHUNK_SIZE - stream->avail_out);
+
+        if (result == Z_STREAM_END) {
+            break;
+        }
+    } while (stream->avail_out == 0);
+
+    return true;
+}
+
+static bool game_tiled_decode_base64(TiledReader* reader, TiledSpan data) {
+
+    static int8_t lookup[256];
+    if (!lookup['B']) {
+        memset(lookup, -1, sizeof(lookup));
+        for (int32_t i = 0; i < 64; ++i) {
+            lookup[(uint8_t) base64_table_[i]] = i;
+        }
+    }
+
+    uint8_t* out = reader->decoded;
+    uint32_t quad = 0;
+    uint32_t quad_count = 0;
+
+    for (const char* c = data.start; c < data.end; ++c) {
+        int8_t value = lookup[(uint8_t) *c];
+
+        // Whitespace and padding
+        if (value < 0) {
+            continue;
+        }
+
+        quad = (quad << 6) | value;
+        if (++quad_count < 4) {
+            continue;
+        }
+
+        out[0] = (uint8_t) (quad >> 16);
+        out[1] = (uint8_t) (quad >> 8);
+        out[2] = (uint8_t) (quad);
+        out += 3;
+
+        quad = 0;
+        quad_count = 0;
+
+        if (out - reader->decoded > TILED_CHUNK_SIZE - 3) {
+            if (!game_tiled_reader_put_decoded(reader, reader->decoded, out - reader->decoded)) {
+                return false;
+            }
+            out = reader->decoded;
+        }
+    }
+
+    // Padded tail
+    if (quad_count == 2) {
+        *out++ = (uint8_t) (quad >> 4);
+    } else if (quad_count == 3) {
+        *out++ = (uint8_t) (quad >> 10);
+        *out++ = (uint8_t) (quad >> 2);
+    }
+
+    return game_tiled_reader_put_decoded(reader, reader->decoded, out - reader->decoded);
+}
+
+static void game_tiled_decode_csv(TiledReader* reader, TiledSpan data) {
+
+    const char* c = data.start;
+
+    while (c < data.end) {
+
+        // Skip separators
+        while (c < data.end && !(*c >= '0' && *c <= '9') && *c != '-') {
+            c++;
+        }
+        if (c >= data.end) {
+            break;
+        }
+
+        bool negative = (*c == '-');
+        if (negative) {
+            c++;
+        }
+
+        uint32_t value = 0;
+        while (c < data.end && *c >= '0' && *c <= '9') {
+            value = value * 10 + (*c++ - '0');
+        }
+
+        game_tiled_reader_put(reader, (negative) ? 0 : value + reader->csv_offset);
+    }
+}
+
+static bool game_tiled_decode_layer(TiledReader* reader, const TiledLayer* layer) {
+
+    if (!layer->width || !layer->height) {
+        printf("ERROR: Tile layer has no size.\n");
+        return false;
+    }
+
+    reader->width  = layer->width;
+    reader->height = layer->height;
+
+    if (layer->width > reader->level->size || layer->height > reader->level->size) {
+        printf(
+            "WARNING: Map of size '%ux%u' is clipped to the level size '%ux%u'.\n",
+            layer->width, layer->height, reader->level->size, reader->level->size
+        );
+    }
+
+    if (!layer->encoding.start || game_tiled_span_equals(layer->encoding, "csv")) {
+        game_tiled_decode_csv(reader, layer->data);
+        return true;
+    }
+
+    if (!game_tiled_span_equals(layer->encoding, "base64")) {
+        printf("ERROR: Unsupported layer encoding '%.*s'.\n", (int) (layer->encoding.end - layer->encoding.start), layer->encoding.start);
+        return false;
+    }
+
+    if (layer->compression.start && layer->compression.end != layer->compression.start) {
+        if (!game_tiled_span_equals(layer->compression, "zlib") && !game_tiled_span_equals(layer->compression, "gzip")) {
+            printf("ERROR: Unsupported layer compression '%.*s'.\n", (int) (layer->compression.end - layer->compression.start), layer->compression.start);
+            return false;
+        }
+
+        // Detects zlib and gzip headers
+        if (inflateInit2(&reader->stream, 15 + 32) != Z_OK) {
+            printf("ERROR: Failed to initialize the layer decompressor.\n");
+            return false;
+        }
+        reader->compressed = true;
+    }
+
+    bool success = game_tiled_decode_base64(reader, layer->data);
+
+    if (reader->compressed) {
+        inflateEnd(&reader->stream);
+    }
+
+    return success;
+}
+
+static TiledSpan game_tiled_xml_element(const char* start, const char* end, const char* tag) {
+    const char* element = start;
+
+    // Skip tags that only share the prefix, <layer> and <layers>
+    while ((element = game_tiled_find(element, end, tag)) != NULL) {
+        const char* after = element + strlen(tag);
+        if (after < end && (*after == ' ' || *after == '>' || *after == '\n' || *after == '\t' || *after == '/')) {
+            const char* close = memchr(after, '>', end - after);
+            return (TiledSpan) { element, (close) ? close + 1 : end };
+        }
+        element = after;
+    }
+
+    return (TiledSpan) { NULL, NULL };
+}
+
+static TiledSpan game_tiled_xml_attribute(TiledSpan element, const char* name) {
+    size_t len = strlen(name);
+    const char* c = element.start;
+
+    while ((c = game_tiled_find(c, element.end, name)) != NULL) {
+        const char* after = c + len;
+
+        if (c[-1] == ' ' || c[-1] == '\n' || c[-1] == '\t') {
+            if (after + 1 < element.end && after[0] == '=' && (after[1] == '"' || after[1] == '\'')) {
+                const char* value = after + 2;
+                const char* value_end = memchr(value, after[1], element.end - value);
+                if (value_end) {
+                    return (TiledSpan) { value, value_end };
+                }
+            }
+        }
+
+        c = after;
+    }
+
+    return (TiledSpan) { NULL, NULL };
+}
+
+static bool game_tiled_import_tmx(TiledReader* reader, const char* start, const char* end) {
+
+    TiledSpan map = game_tiled_xml_element(start, end, "<map");
+    if (!map.start) {
+        printf("ERROR: File is not a TMX map.\n");
+        return false;
+    }
+
+    if (game_tiled_span_equals(game_tiled_xml_attribute(map, "infinite"), "1")) {
+        printf("ERROR: Infinite maps are not supported.\n");
+        return false;
+    }
+
+    TiledSpan tileset = game_tiled_xml_element(map.end, end, "<tileset");
+    if (tileset.start) {
+        TiledSpan first_gid = game_tiled_xml_attribute(tileset, "firstgid");
+        if (first_gid.start) {
+            reader->first_gid = game_tiled_span_uint(first_gid);
+        }
+    }
+
+    TiledSpan layer_element = game_tiled_xml_element(map.end, end, "<layer");
+    if (!layer_element.start) {
+        printf("ERROR: Map doesn't contain a tile layer.\n");
+        return false;
+    }
+
+    TiledSpan data_element = game_tiled_xml_element(layer_element.end, end, "<data");
+    const char* data_end;
+    if (!data_element.start || !(data_end = game_tiled_find(data_element.end, end, "</data>"))) {
+        printf("ERROR: Tile layer doesn't contain data.\n");
+        return false;
+    }
+
+    TiledLayer layer = (TiledLayer) {
+        .width  = game_tiled_span_uint(game_tiled_xml_attribute(layer_element, "width")),
+        .height = game_tiled_span_uint(game_tiled_xml_attribute(layer_element, "height")),
+
+        .encoding    = game_tiled_xml_attribute(data_element, "encoding"),
+        .compression = game_tiled_xml_attribute(data_element, "compression"),
+        .data = (TiledSpan) { data_element.end, data_end },
+    };
+
+    if (!layer.encoding.start) {
+        printf("ERROR: XML tile data is not supported, use csv or base64.\n");
+        return false;
+    }
+
+    return game_tiled_decode_layer(reader, &layer);
+}
+
+static const char* game_tiled_json_skip_space(const char* c, const char* end) {
+    while (c < end && (*c == ' ' || *c == '\n' || *c == '\r' || *c == '\t')) {
+        c++;
+    }
+    return c;
+}
+
+static const char* game_tiled_json_string(const char* c, const char* end, TiledSpan* span) {
+    const char* start = ++c;
+
+    while (c < end && *c != '"') {
+        c += (*c == '\\') ? 2 : 1;
+    }
+
+    if (span) {
+        *span = (TiledSpan) { start, (c < end) ? c : end };
+    }
+
+    return (c < end) ? c + 1 : end;
+}
+
+static const char* game_tiled_json_value(const char* c, const char* end, TiledSpan* span) {
+    c = game_tiled_json_skip_space(c, end);
+    if (c >= end) {
+        return end;
+    }
+
+    if (*c == '"') {
+        return game_tiled_json_string(c, end, span);
+    }
+
+    const char* start = c;
+
+    // Containers are skipped as a whole, strings inside them can hold brackets
+    if (*c == '{' || *c == '[') {
+        int32_t depth = 0;
+
+        while (c < end) {
+            if (*c == '"') {
+                c = game_tiled_json_string(c, end, NULL);
+                continue;
+            }
+
+            if (*c == '{' || *c == '[') {
+                depth++;
+            } else if ((*c == '}' || *c == ']') && --depth == 0) {
+                c++;
+                break;
+            }
+            c++;
+        }
+    } else {
+        while (c < end && *c != ',' && *c != '}' && *c != ']') {
+            c++;
+        }
+    }
+
+    if (span) {
+        *span = (TiledSpan) { start, c };
+    }
+
+    return c;
+}
+
+// Calls back for every key of the object c points at, returns the position after it
+typedef void (*tiled_json_key_func_t) (TiledSpan key, TiledSpan value, void* user);
+
+static const char* game_tiled_json_object(const char* c, const char* end, tiled_json_key_func_t func, void* user) {
+    c = game_tiled_json_skip_space(c, end);
+    if (c >= end || *c != '{') {
+        return end;
+    }
+    c++;
+
+    while (c < end) {
+        c = game_tiled_json_skip_space(c, end);
+        if (c >= end || *c == '}') {
+            return c + 1;
+        }
+        if (*c == ',') {
+            c++;
+            continue;
+        }
+
+        TiledSpan key;
+        c = game_tiled_json_string(c, end, &key);
+        c = game_tiled_json_skip_space(c, end);
+        if (c < end && *c == ':') {
+            c++;
+        }
+
+        TiledSpan value;
+        c = game_tiled_json_value(c, end, &value);
+
+        func(key, value, user);
+    }
+
+    return end;
+}
+
+static void game_tiled_json_tileset_key(TiledSpan key, TiledSpan value, void* user) {
+    if (game_tiled_span_equals(key, "firstgid")) {
+        *((uint32_t*) user) = game_tiled_span_uint(value);
+    }
+}
+
+// Layer scan state, only the first tile layer is imported
+typedef struct TiledJsonLayer {
+    TiledLayer layer;
+    bool tile_layer;
+} TiledJsonLayer;
+
+static void game_tiled_json_layer_key(TiledSpan key, TiledSpan value, void* user) {
+    TiledJsonLayer* json_layer = (TiledJsonLayer*) user;
+    TiledLayer* layer = &json_layer->layer;
+
+    if (game_tiled_span_equals(key, "type")) {
+        json_layer->tile_layer = game_tiled_span_equals(value, "tilelayer");
+    } else if (game_tiled_span_equals(key, "width")) {
+        layer->width = game_tiled_span_uint(value);
+    } else if (game_tiled_span_equals(key, "height")) {
+        layer->height = game_tiled_span_uint(value);
+    } else if (game_tiled_span_equals(key, "encoding")) {
+        layer->encoding = value;
+    } else if (game_tiled_span_equals(key, "compression")) {
+        layer->compression = value;
+    } else if (game_tiled_span_equals(key, "data")) {
+        layer->data = value;
+    }
+}
+
+typedef struct TiledJsonMap {
+    uint32_t first_gid;
+    TiledJsonLayer layer;
+    bool found;
+    bool infinite;
+} TiledJsonMap;
+
+static void game_tiled_json_map_key(TiledSpan key, TiledSpan value, void* user) {
+    TiledJsonMap* map = (TiledJsonMap*) user;
+
+    if (game_tiled_span_equals(key, "infinite")) {
+        map->infinite = game_tiled_span_equals(value, "true");
+        return;
+    }
+
+    bool tilesets = game_tiled_span_equals(key, "tilesets");
+    bool layers   = game_tiled_span_equals(key, "layers");
+    if (!tilesets && !layers) {
+        return;
+    }
+
+    // Walk the array elements in place
+    const char* c = game_tiled_json_skip_space(value.start + 1, value.end);
+    while (c < value.end && *c == '{') {
+
+        if (tilesets) {
+            c = game_tiled_json_object(c, value.end, game_tiled_json_tileset_key, &map->first_gid);
+            break;
+        }
+
+        TiledJsonLayer layer = {0};
+        c = game_tiled_json_object(c, value.end, game_tiled_json_layer_key, &layer);
+
+        if (layer.tile_layer && !map->found) {
+            map->layer = layer;
+            map->found = true;
+        }
+
+        c = game_tiled_json_skip_space(c, value.end);
+        if (c < value.end && *c == ',') {
+            c = game_tiled_json_skip_space(c + 1, value.end);
+        }
+    }
+}
+
+static bool game_tiled_import_json(TiledReader* reader, const char* start, const char* end) {
+
+    TiledJsonMap map = (TiledJsonMap) {
+        .first_gid = TILED_FIRST_GID,
+    };
+
+    game_tiled_json_object(start, end, game_tiled_json_map_key, &map);
+
+    if (map.infinite) {
+        printf("ERROR: Infinite maps are not supported.\n");
+        return false;
+    }
+
+    if (!map.found || !map.layer.layer.data.start) {
+        printf("ERROR: Map doesn't contain a tile layer.\n");
+        return false;
+    }
+
+    reader->first_gid = map.first_gid;
+
+    return game_tiled_decode_layer(reader, &map.layer.layer);
+}
+
+static bool game_tiled_import_csv(TiledReader* reader, const char* start, const char* end) {
+
+    // The grid size comes from the first row and the row count
+    uint32_t width = 1;
+    uint32_t height = 0;
+
+    const char* line_end = memchr(start, '\n', end - start);
+    for (const char* c = start; c < ((line_end) ? line_end : end); ++c) {
+        width += (*c == ',');
+    }
+
+    for (const char* c = start; c < end; ++c) {
+        c = memchr(c, '\n', end - c);
+        if (!c) {
+            break;
+        }
+        height++;
+    }
+    if (end > start && end[-1] != '\n') {
+        height++;
+    }
+
+    // Plain grids store tile ids with -1 as empty
+    reader->first_gid = TILED_FIRST_GID;
+    reader->csv_offset = TILED_FIRST_GID;
+
+    TiledLayer layer = (TiledLayer) {
+        .width = width,
+        .height = height,
+        .data = (TiledSpan) { start, end },
+    };
+
+    return game_tiled_decode_layer(reader, &layer);
+}
+
+// Format
+int32_t game_tiled_format_from_path(const char* path) {
+    const char* extension = strrchr(path, '.');
+    if (!extension) {
+        return TILED_FORMAT_NONE;
+    }
+
+    if (strcmp(extension, ".tmx") == STR_EQUAL) {
+        return TILED_FORMAT_TMX;
+    } else if (strcmp(extension, ".json") == STR_EQUAL || strcmp(extension, ".tmj") == STR_EQUAL) {
+        return TILED_FORMAT_JSON;
+    } else if (strcmp(extension, ".csv") == STR_EQUAL) {
+        return TILED_FORMAT_CSV;
+    }
+
+    return TILED_FORMAT_NONE;
+}
+
+// Export
+bool game_tiled_export(Level* level, const char* path, int32_t format, int32_t compression, const TiledTileset* tileset) {
+
+    if (format != TILED_FORMAT_TMX && format != TILED_FORMAT_JSON && format != TILED_FORMAT_CSV) {
+        printf("ERROR: Unknown Tiled export format '%d'.\n", format);
+        return false;
+    }
+
+    if (compression < TILED_COMPRESSION_NONE || compression > TILED_COMPRESSION_GZIP) {
+        printf("ERROR: Unknown Tiled layer compression '%d'.\n", compression);
+        return false;
+    }
+
+    // Tile size of the map follows the tileset
+    uint32_t tile_width  = (tileset && tileset->tile_width)  ? tileset->tile_width  : 1;
+    uint32_t tile_height = (tileset && tileset->tile_height) ? tileset->tile_height : 1;
+
+    FILE* file;
+    if (!(file = fopen(path, "wb"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        return false;
+    }
+
+    // Plain grids have no header or tileset
+    if (format == TILED_FORMAT_CSV) {
+        game_tiled_write_csv(file, level);
+        return fclose(file) == 0;
+    }
+
+    if (!tileset || !tileset->image) {
+        printf("WARNING: Exporting '%s' without a tileset.\n", path);
+    }
+
+    // Written relative to the exported file, the same way Tiled saves it
+    char image[TILED_PATH_SIZE];
+    TiledTileset relative;
+
+    if (tileset && tileset->image) {
+        game_tiled_relative_path(tileset->image, path, image, sizeof(image));
+
+        relative = *tileset;
+        relative.image = image;
+        tileset = &relative;
+    }
+
+    TiledWriter* writer = (TiledWriter*) malloc(sizeof(TiledWriter));
+    *writer = (TiledWriter) {
+        .file = file,
+        .compression = compression,
+    };
+
+    if (compression != TILED_COMPRESSION_NONE) {
+        int32_t window_bits = (compression == TILED_COMPRESSION_GZIP) ? 15 + 16 : 15;
+
+        if (deflateInit2(&writer->stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            printf("ERROR: Failed to initialize the layer compressor.\n");
+
+            free(writer);
+            fclose(file);
+            return false;
+        }
+    }
+
+    if (format == TILED_FORMAT_TMX) {
+        game_tiled_write_tmx_header(file, level, compression, tileset, tile_width, tile_height);
+    } else {
+        game_tiled_write_json_header(file, level, compression, tileset, tile_width, tile_height);
+    }
+
+    bool success = game_tiled_write_layer_data(writer, level);
+
+    if (format == TILED_FORMAT_TMX) {
+        game_tiled_write_tmx_footer(file);
+    } else {
+        game_tiled_write_json_footer(file);
+    }
+
+    if (compression != TILED_COMPRESSION_NONE) {
+        deflateEnd(&writer->stream);
+    }
+
+    free(writer);
+
+    if (fclose(file) != 0) {
+        printf("ERROR: Failed to write '%s'.\n", path);
+        return false;
+    }
+
+    return success;
+}
+
+// Import
+bool game_tiled_import(Level* level, const char* path, int32_t format) {
+
+    // Tokens point straight into the mapping
+    FileView view;
+    if (!file_load(&view, path, FILE_LOAD_MAP)) {
+        return false;
+    }
+
+    if (view.size == 0) {
+        printf("ERROR: File '%s' is empty.\n", path);
+        file_release(&view);
+        return false;
+    }
+
+    const char* file = view.data;
+    size_t size = view.size;
+
+    // Decode next to the level, a failed import leaves it untouched
+    size_t cell_count = (size_t) level->size * level->size;
+    int32_t* cells = (int32_t*) malloc(sizeof(int32_t) * cell_count);
+    for (size_t i = 0; i < cell_count; ++i) {
+        cells[i] = LEVEL_EMPTY_TILE;
+    }
+
+    TiledReader* reader = (TiledReader*) malloc(sizeof(TiledReader));
+    *reader = (TiledReader) {
+        .level = level,
+        .cells = cells,
+        .first_gid = TILED_FIRST_GID,
+    };
+
+    bool success = false;
+    switch (format) {
+    case TILED_FORMAT_TMX:
+        success = game_tiled_import_tmx(reader, file, file + size);
+        break;
+    case TILED_FORMAT_JSON:
+        success = game_tiled_import_json(reader, file, file + size);
+        break;
+    case TILED_FORMAT_CSV:
+        success = game_tiled_import_csv(reader, file, file + size);
+        break;
+    default:
+        printf("ERROR: Unknown Tiled import format '%d'.\n", format);
+        break;
+    }
+
+    // A truncated layer is as broken as one that didn't parse
+    if (success && reader->row < reader->height) {
+        printf("ERROR: Layer data ended after %u of %u rows.\n", reader->row, reader->height);
+        success = false;
+    }
+
+    if (success) {
+
+        // Decoding wrote straight into the cells, rebuild the counters once
+        free(level->data);
+        level->data = cells;
+
+        game_level_recalculate_stats(level);
+    } else {
+        free(cells);
+    }
+
+    free(reader);
+    file_release(&view);
+
+    return success;
+}
\ No newline at end of file
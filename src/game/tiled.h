@@ -0,0 +1,36 @@
+#pragma once
+
+#include "util/common.h"
+
+#include "level.h"
+
+
+// Formats
+#define TILED_FORMAT_NONE   -1
+#define TILED_FORMAT_TMX     0
+#define TILED_FORMAT_JSON    1
+#define TILED_FORMAT_CSV     2
+
+// Layer data compression
+#define TILED_COMPRESSION_NONE  0
+#define TILED_COMPRESSION_ZLIB  1
+#define TILED_COMPRESSION_GZIP  2
+
+// Tileset referenced by the exported map, image can be NULL. A relative image is resolved against the working directory
+typedef struct TiledTileset {
+    const char* image;
+    uint32_t image_width;
+    uint32_t image_height;
+
+    uint32_t tile_width;
+    uint32_t tile_height;
+} TiledTileset;
+
+// Format
+int32_t game_tiled_format_from_path(const char* path);
+
+// Export
+bool game_tiled_export(Level* level, const char* path, int32_t format, int32_t compression, const TiledTileset* tileset);
+
+// Import
+bool game_tiled_import(Level* level, const char* path, int32_t format);
\ No newline at end of file
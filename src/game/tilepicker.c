@@ -0,0 +1,23 @@
+#include "tilepicker.h"
+
+
+// Hit testing
+int32_t game_tilepicker_hit(const VECTOR(Tile)* tiles, float render_offset, const double* cursor_pos) {
+
+    for (uint32_t i = 0; i < tiles->count; ++i) {
+
+        const Tile* current = &tiles->array[i];
+
+        vec2s current_pos = (vec2s) {
+            current->pos.x,
+            render_offset + current->pos.y,
+        };
+
+        if ((cursor_pos[0] >= current_pos.x && cursor_pos[0] <= current_pos.x + current->size) &&
+            (cursor_pos[1] >= current_pos.y && cursor_pos[1] <= current_pos.y + current->size)) {
+            return current->index;
+        }
+    }
+
+    return -1;
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Tile of the tilepicker grid, pos is in screen space before scrolling
+typedef struct Tile {
+    vec2s pos;
+    vec4s source;
+    float size;
+    uint32_t index;
+} Tile;
+VECTOR_DECLARE(Tile, 0);
+
+// Hit testing, returns the index of the tile under the cursor or -1
+int32_t game_tilepicker_hit(const VECTOR(Tile)* tiles, float render_offset, const double* cursor_pos);
\ No newline at end of file
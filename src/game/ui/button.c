@@ -1,3 +1,4 @@
+#define HEAP_TAG HEAP_TAG_UI
 #include "button.h"
 
 #include "label.h"
@@ -40,7 +41,7 @@ UINode* ui_button_new(const char* text, vec2s position, ui_btn_func_t callback)
 
     // Add label to children
     text_node->parent = node;
-    LIST_PUSH(node->children, text_node);
+    VECTOR_PUSH(&node->children, text_node);
 
     // Center the label
     ui_label_set_alignment_to_parent(text_node, 0);
@@ -131,7 +132,7 @@ void ui_button_update(UINode* node) {
     engine_shader_unbind(quad_shader);
 
     // Update the children
-    UINode* label = LIST_GET(node->children, 0);
+    UINode* label = VECTOR_GET(&node->children, 0);
     ui_label_update(label);
 }
 
@@ -1,3 +1,4 @@
+#define HEAP_TAG HEAP_TAG_UI
 #include "input.h"
 
 #include "engine/renderer.h"
@@ -34,7 +35,9 @@ UINode* ui_input_new(const char* placeholder, vec2s pos) {
         .cursor_over = false,
         .on_focus = false
     };
-    input->buffer = LIST_NEW(input->buffer, char);
+    VECTOR_INIT(&input->buffer, NULL);
+    VECTOR_RESERVE(&input->buffer, input->max_input + 1);
+    input->buffer.array[0] = '\0';
 
     return node;
 }
@@ -47,7 +50,7 @@ void ui_input_free(UINode* node) {
     }
 
     // Free the buffer
-    LIST_FREE(input->buffer);
+    VECTOR_FREE(&input->buffer);
 
     // Free the input
     free(input);
@@ -82,40 +85,28 @@ void ui_input_update(UINode* node) {
 
         ui_set_input_mode(true);
 
-        LIST_TYPE(char) char_pressed = engine_input_get_chars_pressed();
-        LIST_TYPE(KeyAction) key_pressed = engine_input_get_keys_pressed();
+        const VECTOR(char)* char_pressed = engine_input_get_chars_pressed();
+        const VECTOR(KeyAction)* key_pressed = engine_input_get_keys_pressed();
 
-        for (int32_t i = 0; i < char_pressed->count; ++i) {
-            LIST_PUSH(input->buffer, LIST_GET(char_pressed, i));
-        }
+        VECTOR_APPEND(&input->buffer, char_pressed->array, char_pressed->count);
 
-        for (int32_t i = 0; i < key_pressed->count; ++i) {
-            const KeyAction* key = &LIST_GET(key_pressed, i);
+        for (uint32_t i = 0; i < key_pressed->count; ++i) {
+            const KeyAction* key = &VECTOR_GET(key_pressed, i);
 
             if (key->key == GLFW_KEY_BACKSPACE && 
                 (key->state == INPUT_KEY_PRESS || key->state == INPUT_KEY_REPEAT)) {
                 
-                if (input->buffer->count == 0) {
+                if (input->buffer.count == 0) {
                     break;
                 }
 
-                input->buffer->array[input->buffer->count - 1] = '\0';
-                input->buffer->count--;
+                input->buffer.count--;
             }
         }
 
-        if (input->buffer->count != input->buffer->capacity) {
-
-            input->buffer->array[input->buffer->count] = '\0';
-        } else {
-            input->buffer->capacity *= 2;
-            input->buffer->array = (char*) realloc(
-                input->buffer->array, 
-                sizeof(char) * input->buffer->capacity
-            );
-
-            input->buffer->array[input->buffer->count] = '\0';
-        }
+        // Keep room for the terminator
+        VECTOR_RESERVE(&input->buffer, input->buffer.count + 1);
+        input->buffer.array[input->buffer.count] = '\0';
     }
 
     // Render
@@ -142,9 +133,9 @@ void ui_input_update(UINode* node) {
     engine_shader_unbind(quad_shader);
 
     // Render the buffer
-    const char* text = (input->buffer->count) ? input->buffer->array : input->place_holder;
+    const char* text = (input->buffer.count) ? input->buffer.array : input->place_holder;
 
-    vec4s text_color = (input->buffer->count) ? INPUT_DEFAULT_COLOR : (vec4s) {0.6, 0.6, 0.6, 1};
+    vec4s text_color = (input->buffer.count) ? INPUT_DEFAULT_COLOR : (vec4s) {0.6, 0.6, 0.6, 1};
 
     vec2s text_size = engine_font_get_text_size(
         (Font*) ui_default_font(), 
@@ -7,7 +7,7 @@
 
 // Type
 typedef struct UIInput {
-    LIST_TYPE(char) buffer;
+    VECTOR(char) buffer; // Always null terminated
 
     const char* place_holder;
     uint32_t max_input;
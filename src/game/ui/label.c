@@ -1,3 +1,4 @@
+#define HEAP_TAG HEAP_TAG_UI
 #include "label.h"
 
 #include "engine/renderer.h"
@@ -104,8 +105,9 @@ void ui_label_set_text(UINode* node, const char* text) {
         return;
     }
 
+    // Grow geometrically so labels that are updated every frame settle quickly
     if (len > label->capacity) {
-        label->capacity = len;
+        label->capacity = (len > label->capacity * 2) ? len : label->capacity * 2;
 
         free(label->buffer);
         label->buffer = (char*) calloc(label->capacity, sizeof(char));
@@ -1,3 +1,4 @@
+#define HEAP_TAG HEAP_TAG_UI
 #include "panel.h"
 
 #include "label.h"
@@ -42,7 +43,7 @@ UINode* ui_panel_new(const char* text, vec2s pos, vec2s size) {
 
     // Add label to children
     text_node->parent = node;
-    LIST_PUSH(node->children, text_node);
+    VECTOR_PUSH(&node->children, text_node);
 
     // Center the label
     ui_label_set_alignment_to_parent(text_node, 0);
@@ -113,8 +114,8 @@ void ui_panel_update(UINode* node) {
     engine_shader_unbind(quad_shader);
     
     // Children update
-    for (int32_t i = 0; i < node->children->count; ++i) {
-        UINode* child = LIST_GET(node->children, i);
+    for (uint32_t i = 0; i < node->children.count; ++i) {
+        UINode* child = VECTOR_GET(&node->children, i);
         
         switch (child->type) {
             case UI_TYPE_NONE:
@@ -148,7 +149,7 @@ void ui_panel_add_node(UINode* node, UINode* child) {
 
     // ADd child to panel's children
     child->parent = node;
-    LIST_PUSH(node->children, child);
+    VECTOR_PUSH(&node->children, child);
     
     // Set child pos
     ui_node_set_position(
@@ -1,3 +1,4 @@
+#define HEAP_TAG HEAP_TAG_UI
 #include "ui.h"
 
 #include "engine/window.h"
@@ -62,8 +63,8 @@ UINode* ui_node_new(vec2s pos, vec2s size) {
         .parent = NULL,
     };
 
-    // Allocate the list
-    n->children = LIST_PTR_NEW(n->children, UINode);
+    // Initialize the children
+    VECTOR_INIT(&n->children, NULL);
 
     return n;
 }
@@ -96,12 +97,12 @@ void ui_node_free(UINode* node) {
     }
 
     // Destroy child
-    for (int i = 0; i < node->children->count; ++i) {
-        ui_node_free(LIST_GET(node->children, i));
+    for (uint32_t i = 0; i < node->children.count; ++i) {
+        ui_node_free(VECTOR_GET(&node->children, i));
     }
 
     // Free children list
-    LIST_FREE(node->children);
+    VECTOR_FREE(&node->children);
 
     // Free the node
     free(node);
@@ -126,8 +127,8 @@ void ui_node_set_position(UINode* node, vec2s pos) {
     }
 
     // Update the children
-    for (int32_t i = 0; i < node->children->count; ++i) {
-        ui_node_update_position(LIST_GET(node->children, i));
+    for (uint32_t i = 0; i < node->children.count; ++i) {
+        ui_node_update_position(VECTOR_GET(&node->children, i));
     }
 }
 
@@ -136,7 +137,7 @@ const Font* ui_default_font() {
     return (const Font*) default_font_;
 }
 
-const Shader ui_default_shader() {
+Shader ui_default_shader() {
     return default_shader_;
 }
 
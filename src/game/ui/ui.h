@@ -1,7 +1,7 @@
 #pragma once
 
 #include "util/common.h"
-#include "util/list.h"
+#include "util/vector.h"
 
 #include "engine/font.h"
 #include "engine/shader.h"
@@ -19,7 +19,8 @@ typedef int32_t node_t;
 // Node
 typedef struct UINode UINode;
 
-LIST_PTR_DECLARE(UINode);
+// Most nodes have a label or a few buttons, keep those inline
+VECTOR_PTR_DECLARE(UINode, 4);
 
 struct UINode {
     vec2s pos;
@@ -32,7 +33,7 @@ struct UINode {
     node_t type;
 
     struct UINode* parent;
-    LIST_PTR_TYPE(UINode) children;
+    VECTOR_PTR(UINode) children;
 };
 
 // Creation and termination
@@ -47,7 +48,7 @@ void ui_node_set_position(UINode* node, vec2s pos);
 // UI General
 const Font* ui_default_font();
 
-const Shader ui_default_shader();
+Shader ui_default_shader();
 
 void ui_set_input_mode(bool value);
 
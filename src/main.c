@@ -1,4 +1,5 @@
 #include "game/scene/menu.h"
+#include "game/scene/stress.h"
 
 #include "engine/engine.h"
 #include "engine/init.h"
@@ -7,8 +8,12 @@
 #include "engine/texture.h"
 #include "engine/font.h"
 #include "engine/renderer.h"
+#include "engine/replay.h"
+#include "engine/capture.h"
 
 #include "util/common.h"
+#include "util/file.h"
+#include "util/heap.h"
 
 
 // Scene count
@@ -21,6 +26,30 @@ int main(int argc, char* argv[]) {
         printf("ARG %d: '%s'\n", i, argv[i]);
     }
 
+    // Offscreen rendering and golden images, '--headless' and '--capture <frame> <path>'
+    // Load test, '--stress [--stress-size <n>] [--stress-frames <n>]'
+    // Log every file load, '--verbose'
+    bool stress = false;
+    uint32_t stress_size = 0;
+    uint32_t stress_frames = 0;
+
+    for (int32_t i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--headless") == 0) {
+            engine_window_set_headless(true);
+        } else if (strcmp(argv[i], "--verbose") == 0) {
+            file_set_verbose(true);
+        } else if (strcmp(argv[i], "--stress") == 0) {
+            stress = true;
+        } else if (strcmp(argv[i], "--stress-size") == 0 && i + 1 < argc) {
+            stress_size = (uint32_t) atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--stress-frames") == 0 && i + 1 < argc) {
+            stress_frames = (uint32_t) atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 2 < argc) {
+            engine_capture_request(argv[i + 2], (uint32_t) atoi(argv[i + 1]));
+            i += 2;
+        }
+    }
+
     // Initialize the engine
     if (!engine_init()) {
         printf("ERROR: Engine failed to initialize.\n");
@@ -32,14 +61,33 @@ int main(int argc, char* argv[]) {
 
     // Load scene resources
     game_scene_menu_load();
+    game_scene_stress_load();
+
+    game_scene_stress_configure(stress_size, stress_frames);
+
+    file_print_stats("Startup");
 
     // Scene functions
     scene_func_t scene_functions[SCENE_COUNT] = {
         &game_scene_menu,
+        &game_scene_stress,
     };
 
     // Set the initial scene
-    game_scene_menu_set_active();
+    if (stress) {
+        game_scene_stress_set_active();
+    } else {
+        game_scene_menu_set_active();
+    }
+
+    // Input recording and replay, '--record <path>' or '--replay <path>'
+    for (int32_t i = 1; i + 1 < argc; ++i) {
+        if (strcmp(argv[i], "--record") == 0) {
+            engine_replay_record(argv[++i]);
+        } else if (strcmp(argv[i], "--replay") == 0) {
+            engine_replay_play(argv[++i]);
+        }
+    }
 
     while(!glfwWindowShouldClose(window)) {
 
@@ -53,9 +101,13 @@ int main(int argc, char* argv[]) {
     }
 
     // Free scene resources
-    game_scene_menu_load();
+    game_scene_menu_free();
+    game_scene_stress_free();
 
     engine_terminate();
 
+    // Anything still live here is a leak
+    heap_print_stats("Exit");
+
     return 0;
 }
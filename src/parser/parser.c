@@ -1,202 +1,372 @@
+#define HEAP_TAG HEAP_TAG_PARSER
 #include "parser.h"
 
-#include "../util/util.h"
+#include "tokenizer.h"
 
-// TODO: Fix potential memory leak
-Map* parser_parse_yaml(const char* path) {
-    char* file = read_file(path);
-    if (!file) {
-        return NULL;
+#include "../util/util.h"
+#include "../util/file.h"
+#include "../util/intern.h"
+#include "../util/arena.h"
+
+// Open container while building, children are more indented than their container
+typedef struct ParserScope {
+    uint32_t node;
+    int32_t indent;
+    bool keyed; // Created by a 'key:' line, items at the same indent still belong to it
+} ParserScope;
+
+// Static
+static uint32_t parser_pow2(uint32_t value) {
+    uint32_t result = 2;
+    while (result < value) {
+        result *= 2;
     }
 
-    Map map = map_new();
+    return result;
+}
 
-    char* crnt = file;
-    char* line = NULL;
-    while ((line = get_line(crnt)) != NULL) {
+static uint32_t parser_add_node(ParserDocument* document, uint32_t parent, int32_t type, ParserSpan key, ParserSpan value) {
+    uint32_t index = document->node_count++;
 
-        size_t len = line - crnt + 1;
-        char* str = (char*) calloc(len + 1, sizeof(char));
-        char* ptr = str;
+    document->nodes[index] = (ParserNode) {
+        .type = type,
 
-        bool start = true;
-        bool in_word = false;
+        .key = (key.len) ? key.start : NULL,
+        .key_len = key.len,
+        .hash = (key.len) ? intern_hash(key.start, key.len) : 0,
 
-        for (char* c = crnt; c <= line; ++c) {
+        .value = (type == PARSER_NODE_SCALAR) ? value.start : NULL,
+        .value_len = (type == PARSER_NODE_SCALAR) ? value.len : 0,
 
-            char chr = *c;
+        .parent = parent,
+        .first_child = PARSER_NODE_NONE,
+        .last_child = PARSER_NODE_NONE,
+        .next_sibling = PARSER_NODE_NONE,
+        .child_count = 0,
+    };
 
-            if (chr == '#') {
-                break;
-            }
+    if (parent != PARSER_NODE_NONE) {
+        ParserNode* parent_node = &document->nodes[parent];
+
+        if (parent_node->last_child == PARSER_NODE_NONE) {
+            parent_node->first_child = index;
+        } else {
+            document->nodes[parent_node->last_child].next_sibling = index;
+        }
 
-            if (!in_word && chr != ' ' && chr != '\t') {
-                in_word = true;
+        parent_node->last_child = index;
+        parent_node->child_count++;
+    }
 
-                if (!start) {
-                    bool space = true;
-                    if (c != line && *(c + 1) == '#') {
-                        space = false;
-                    }
-                    if (space) {
-                        *ptr = ' ';
-                        ptr++;
-                    }
-                }
-            } if (in_word && (chr == ' ' || chr == '\t')) {
-                in_word = false;
+    return index;
+}
 
-                if (start) {
-                    start = false;
-                }
+static void parser_build_index(ParserDocument* document) {
+    uint32_t used = 0;
+
+    for (uint32_t i = 0; i < document->node_count; ++i) {
+        ParserNode* node = &document->nodes[i];
+
+        if (node->type == PARSER_NODE_SEQUENCE) {
+            node->slots = used;
+            node->slot_count = node->child_count;
+
+            uint32_t* slots = document->slots + node->slots;
+            for (uint32_t child = node->first_child; child != PARSER_NODE_NONE; child = document->nodes[child].next_sibling) {
+                *slots++ = child;
             }
 
-            if (in_word) {
-                if (c == line && chr == '\n') {
-                    continue;
+        } else if (node->type == PARSER_NODE_MAPPING) {
+            node->slots = used;
+            node->slot_count = parser_pow2(node->child_count * 2);
+
+            // Slots hold the node index + 1, zero is empty
+            uint32_t* slots = document->slots + node->slots;
+            memset(slots, 0, sizeof(uint32_t) * node->slot_count);
+
+            for (uint32_t child = node->first_child; child != PARSER_NODE_NONE; child = document->nodes[child].next_sibling) {
+                ParserNode* child_node = &document->nodes[child];
+
+                uint32_t slot = child_node->hash & (node->slot_count - 1);
+                while (slots[slot]) {
+                    ParserNode* other = &document->nodes[slots[slot] - 1];
+
+                    if (other->hash == child_node->hash && other->key_len == child_node->key_len &&
+                        memcmp(other->key, child_node->key, child_node->key_len) == STR_EQUAL) {
+                        printf("WARNING: Duplicate key '%s', the last definition is used.\n", child_node->key);
+                        break;
+                    }
+
+                    slot = (slot + 1) & (node->slot_count - 1);
                 }
 
-                *ptr = chr;
-                ptr++;
+                slots[slot] = child + 1;
             }
-        }
-
-        size_t str_len = strlen(str);
-        if (str_len <= 0) {
-            free(str);
-            crnt = line + 1;
-            
+        } else {
             continue;
         }
 
-        in_word = true;
+        used += node->slot_count;
+    }
+}
+
+// Document
+ParserDocument* parser_parse_yaml(const char* path) {
+    FileView file;
+    if (!file_load(&file, path, FILE_LOAD_AUTO)) {
+        return NULL;
+    }
 
-        bool token = true;
-        bool value = false;
+    ParserDocument* document = parser_parse_yaml_buffer(file.data, file.size);
+    
+    file_release(&file);
 
-        char* token_str = (char*) calloc(257, sizeof(char));
-        char* token_ptr = token_str;
+    return document;
+}
 
-        char* value_str = (char*) calloc(257, sizeof(char));
-        char* value_ptr = value_str;
+ParserDocument* parser_parse_yaml_buffer(const char* buffer, size_t len) {
 
-        for (char* c = str; c < str + str_len; ++c) {
+    ParserTokenizer tokenizer;
+    ParserToken token;
+    int32_t result;
 
-            char chr = *c;
+    // Count the tokens first so the whole document fits one allocation
+    uint32_t token_count = 0;
 
-            if (!in_word && (chr != ' ' || chr != '\t')) {
-                in_word = true;
-            } else if (in_word && (chr == ' ' || chr == '\t')) {
-                in_word = false;
-            }
+    parser_tokenizer_init(&tokenizer, buffer, len);
+    while ((result = parser_tokenizer_next(&tokenizer, &token)) == PARSER_TOKEN_OK) {
+        token_count++;
+    }
 
-            if (token && in_word) {
-                if (chr == ':') {
-                    token = false;
-                    value = true;
+    if (result == PARSER_TOKEN_ERROR) {
+        return NULL;
+    }
 
-                    if (c == str + str_len - 1) {
-                        break;
-                    }
+    // A line adds at most two nodes, a mapping indexes at most four slots per child
+    uint32_t node_capacity = token_count * 2 + 1;
+    uint32_t slot_capacity = node_capacity * 4 + 2;
 
-                    continue;
-                }
+    size_t size = sizeof(ParserDocument) + sizeof(ParserNode) * node_capacity + sizeof(uint32_t) * slot_capacity + len + 1;
+    char* arena = (char*) malloc(size);
 
-                if (token_ptr - token_str == 256) {
-                    printf("SYNTAX: ERROR: Token name can't be longer than 256 characters.\n");
+    ParserDocument* document = (ParserDocument*) arena;
+    *document = (ParserDocument) {
+        .nodes = (ParserNode*) (arena + sizeof(ParserDocument)),
+        .node_count = 0,
+    };
+    document->slots = (uint32_t*) (document->nodes + node_capacity);
+    document->text = (char*) (document->slots + slot_capacity);
 
-                    free(value_str);
-                    free(token_str);
-                    free(str);
+    memcpy(document->text, buffer, len);
+    document->text[len] = '\0';
 
-                    return NULL;
-                }
+    // Build the tree, spans point into the document text
+    Arena* scratch = arena_scratch();
+    ArenaMark mark = arena_mark(scratch);
 
-                *token_ptr = chr;
-                token_ptr++;
-            } else if (token && !in_word) {
-                
-                if (c == str + str_len - 1) {
-                    printf("SYNTAX: ERROR: Token definition should end with a ':'.\n");
+    ParserScope* scopes = ARENA_ALLOC(scratch, ParserScope, token_count * 2 + 1);
+    uint32_t depth = 0;
 
-                    free(value_str);
-                    free(token_str);
-                    free(str);
+    uint32_t root = parser_add_node(document, PARSER_NODE_NONE, PARSER_NODE_MAPPING, (ParserSpan) {0}, (ParserSpan) {0});
+    scopes[depth++] = (ParserScope) { root, -1, false };
 
-                    return NULL;
-                } else if (*(c + 1) != ':') {
-                    printf("SYNTAX: ERROR: Token name can't contain ' '.\n");
+    bool failed = false;
 
-                    free(value_str);
-                    free(token_str);
-                    free(str);
+    parser_tokenizer_init(&tokenizer, document->text, len);
+    while (parser_tokenizer_next(&tokenizer, &token) == PARSER_TOKEN_OK) {
 
-                    return NULL;
-                }
+        int32_t indent = token.indent;
 
-                token = false;
-                value = true;
+        // Close the containers this line isn't nested in
+        while (depth > 1) {
+            ParserScope* top = &scopes[depth - 1];
+            int32_t type = document->nodes[top->node].type;
+
+            if (top->indent < indent) {
+                break;
+            }
+            if (top->indent == indent && token.item && top->keyed && (type == PARSER_NODE_NULL || type == PARSER_NODE_SEQUENCE)) {
+                break;
             }
 
-            if (value && in_word) {
-                if (c == str + str_len - 1 && chr == ':') {
-                    break;
-                }
-                if (chr == ':') {
-                    continue;
-                }
+            depth--;
+        }
 
-                if (value_ptr - value_str == 256) {
-                    printf("SYNTAX: ERROR: Token value can't be longer than 256 characters.\n");
+        uint32_t parent = scopes[depth - 1].node;
+        ParserNode* parent_node = &document->nodes[parent];
 
-                    free(value_str);
-                    free(token_str);
-                    free(str);
+        if (token.item) {
 
-                    return NULL;
+            if (parent_node->type == PARSER_NODE_NULL) {
+                parent_node->type = PARSER_NODE_SEQUENCE;
+            } else if (parent_node->type != PARSER_NODE_SEQUENCE) {
+                printf("SYNTAX: ERROR: Sequence item inside a mapping (line %u).\n", token.line);
+                failed = true;
+                break;
+            }
+
+            // Scalar item, or an empty one with its content on the next lines
+            if (token.key.len == 0) {
+                if (token.value.len) {
+                    parser_add_node(document, parent, PARSER_NODE_SCALAR, token.key, token.value);
+                } else {
+                    uint32_t item = parser_add_node(document, parent, PARSER_NODE_NULL, token.key, token.value);
+                    scopes[depth++] = (ParserScope) { item, indent, false };
                 }
+                continue;
+            }
+
+            // Mapping item, the following keys line up with its first key
+            uint32_t item = parser_add_node(document, parent, PARSER_NODE_MAPPING, (ParserSpan) {0}, (ParserSpan) {0});
+            scopes[depth++] = (ParserScope) { item, (int32_t) token.key_indent - 1, false };
+
+            parent = item;
+            indent = token.key_indent;
+
+        } else {
 
-                *value_ptr = chr;
-                value_ptr++;
+            if (parent_node->type == PARSER_NODE_NULL) {
+                parent_node->type = PARSER_NODE_MAPPING;
+            } else if (parent_node->type != PARSER_NODE_MAPPING) {
+                printf("SYNTAX: ERROR: Key '%.*s' inside a sequence (line %u).\n", token.key.len, token.key.start, token.line);
+                failed = true;
+                break;
             }
         }
 
-        map_set_key(&map, token_str, value_str);
+        if (token.value.len) {
+            parser_add_node(document, parent, PARSER_NODE_SCALAR, token.key, token.value);
+        } else {
+            uint32_t node = parser_add_node(document, parent, PARSER_NODE_NULL, token.key, token.value);
+            scopes[depth++] = (ParserScope) { node, indent, true };
+        }
+    }
 
-        free(str);
-        free(value_str);
-        free(token_str);
+    arena_restore(scratch, mark);
 
-        crnt = line + 1;
+    if (failed) {
+        free(document);
+        return NULL;
     }
 
-    free(file);
-    
-    Map* m = calloc(1, sizeof(Map));
-    *m = map;
+    // Terminate the spans in place, the tokenizer is done with the text
+    for (uint32_t i = 0; i < document->node_count; ++i) {
+        ParserNode* node = &document->nodes[i];
+
+        if (node->key) {
+            ((char*) node->key)[node->key_len] = '\0';
+        }
+        if (node->value) {
+            ((char*) node->value)[node->value_len] = '\0';
+        }
+    }
 
-    return m;
+    parser_build_index(document);
+
+    return document;
 }
 
-bool parser_yaml_parse_tag(Map* map, const char* key) {
-    const char* value = map_get_key(map, key);
-    if (value == NULL) {
-        printf("ERROR: Map doesn't contain the key '%s'.\n", key);
-        return 0;
+void parser_document_free(ParserDocument* document) {
+    // Nodes, slots and text share the document allocation
+    free(document);
+}
+
+// Lookup
+const ParserNode* parser_document_find(const ParserDocument* document, const char* path) {
+    const ParserNode* node = &document->nodes[0];
+
+    // Dotted path, numeric parts index into sequences
+    const char* c = path;
+    while (node && *c) {
+        const char* end = strchr(c, '.');
+        if (!end) {
+            end = c + strlen(c);
+        }
+
+        uint32_t len = end - c;
+
+        if (node->type == PARSER_NODE_SEQUENCE) {
+            char* number_end;
+            unsigned long index = strtoul(c, &number_end, 10);
+
+            node = (number_end == end && len) ? parser_node_item(document, node, index) : NULL;
+        } else {
+            node = parser_node_find(document, node, c, len, intern_hash(c, len));
+        }
+
+        c = (*end) ? end + 1 : end;
     }
 
-    size_t len = strlen(value);
-    if (len == 0) {
-        return true;
+    return node;
+}
+
+const ParserNode* parser_node_find(const ParserDocument* document, const ParserNode* node, const char* key, uint32_t key_len, uint64_t hash) {
+    if (node->type != PARSER_NODE_MAPPING) {
+        return NULL;
     }
 
-    return false;
+    const uint32_t* slots = document->slots + node->slots;
+
+    uint32_t slot = hash & (node->slot_count - 1);
+    while (slots[slot]) {
+        const ParserNode* child = &document->nodes[slots[slot] - 1];
+
+        if (child->hash == hash && child->key_len == key_len && memcmp(child->key, key, key_len) == STR_EQUAL) {
+            return child;
+        }
+
+        slot = (slot + 1) & (node->slot_count - 1);
+    }
+
+    return NULL;
+}
+
+const ParserNode* parser_node_item(const ParserDocument* document, const ParserNode* node, uint32_t index) {
+    if (node->type != PARSER_NODE_SEQUENCE || index >= node->slot_count) {
+        return NULL;
+    }
+
+    return &document->nodes[document->slots[node->slots + index]];
+}
+
+const char* parser_document_get(const ParserDocument* document, const char* path) {
+    const ParserNode* node = parser_document_find(document, path);
+    if (!node || node->type != PARSER_NODE_SCALAR) {
+        return NULL;
+    }
+
+    return node->value;
+}
+
+// Values
+static const char* parser_yaml_value(ParserDocument* document, const char* path) {
+    const ParserNode* node = parser_document_find(document, path);
+    if (node == NULL) {
+        printf("ERROR: Document doesn't contain the key '%s'.\n", path);
+        return NULL;
+    }
+
+    if (node->type != PARSER_NODE_SCALAR) {
+        printf("ERROR: Key '%s' doesn't have a value.\n", path);
+        return NULL;
+    }
+
+    return node->value;
+}
+
+bool parser_yaml_parse_tag(ParserDocument* document, const char* path) {
+    const ParserNode* node = parser_document_find(document, path);
+    if (node == NULL) {
+        printf("ERROR: Document doesn't contain the key '%s'.\n", path);
+        return false;
+    }
+
+    return node->type != PARSER_NODE_SCALAR;
 }
 
-int parser_yaml_parse_int(Map* map, const char* key) {
-    const char* value = map_get_key(map, key);
+int parser_yaml_parse_int(ParserDocument* document, const char* path) {
+    const char* value = parser_yaml_value(document, path);
     if (value == NULL) {
-        printf("ERROR: Map doesn't contain the key '%s'.\n", key);
         return 0;
     }
 
@@ -211,10 +381,9 @@ int parser_yaml_parse_int(Map* map, const char* key) {
     return 0;
 }
 
-char* parser_yaml_parse_str(Map* map, const char* key) {
-    const char* value = map_get_key(map, key);
+char* parser_yaml_parse_str(ParserDocument* document, const char* path) {
+    const char* value = parser_yaml_value(document, path);
     if (value == NULL) {
-        printf("ERROR: Map doesn't contain the key '%s'.\n", key);
         return 0;
     }
 
@@ -224,10 +393,9 @@ char* parser_yaml_parse_str(Map* map, const char* key) {
     return strcpy(str, value);
 }
 
-bool parser_yaml_parse_bool(Map* map, const char* key) {
-    const char* value = map_get_key(map, key);
+bool parser_yaml_parse_bool(ParserDocument* document, const char* path) {
+    const char* value = parser_yaml_value(document, path);
     if (value == NULL) {
-        printf("ERROR: Map doesn't contain the key '%s'.\n", key);
         return 0;
     }
 
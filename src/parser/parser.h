@@ -1,15 +1,68 @@
 #pragma once
 
-#include "util/map.h"
-
 #include "util/common.h"
 
-Map* parser_parse_yaml(const char* path);
 
-bool parser_yaml_parse_tag(Map* map, const char* key);
+// Node types
+#define PARSER_NODE_NULL        0 // 'key:' without a value or children
+#define PARSER_NODE_SCALAR      1
+#define PARSER_NODE_MAPPING     2
+#define PARSER_NODE_SEQUENCE    3
+
+#define PARSER_NODE_NONE        UINT32_MAX
+
+// Document node, keys and values are null terminated strings inside the document's allocation
+typedef struct ParserNode {
+    int32_t type;
+
+    const char* key; // NULL for the root and sequence items
+    uint32_t key_len;
+    uint64_t hash;
+
+    const char* value; // Scalars only
+    uint32_t value_len;
+
+    uint32_t parent;
+    uint32_t first_child;
+    uint32_t last_child;
+    uint32_t next_sibling;
+    uint32_t child_count;
+
+    // Mappings hash their children by key, sequences index them directly
+    uint32_t slots;
+    uint32_t slot_count;
+} ParserNode;
+
+// Document, everything lives in a single allocation
+typedef struct ParserDocument {
+    ParserNode* nodes; // Root is the first node
+    uint32_t node_count;
+
+    uint32_t* slots;
+    char* text;
+} ParserDocument;
+
+// Document
+ParserDocument* parser_parse_yaml(const char* path);
+
+ParserDocument* parser_parse_yaml_buffer(const char* buffer, size_t len);
+
+void parser_document_free(ParserDocument* document);
+
+// Lookup
+const ParserNode* parser_document_find(const ParserDocument* document, const char* path);
+
+const ParserNode* parser_node_find(const ParserDocument* document, const ParserNode* node, const char* key, uint32_t key_len, uint64_t hash);
+
+const ParserNode* parser_node_item(const ParserDocument* document, const ParserNode* node, uint32_t index);
+
+const char* parser_document_get(const ParserDocument* document, const char* path);
+
+// Values
+bool parser_yaml_parse_tag(ParserDocument* document, const char* path);
 
-int parser_yaml_parse_int(Map* map, const char* key);
+int parser_yaml_parse_int(ParserDocument* document, const char* path);
 
-char* parser_yaml_parse_str(Map* map, const char* key);
+char* parser_yaml_parse_str(ParserDocument* document, const char* path);
 
-bool parser_yaml_parse_bool(Map* map, const char* key);
+bool parser_yaml_parse_bool(ParserDocument* document, const char* path);
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "tokenizer.h"
+
+
+// Static
+static bool parser_is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Tokenizer
+void parser_tokenizer_init(ParserTokenizer* tokenizer, const char* buffer, size_t len) {
+    *tokenizer = (ParserTokenizer) {
+        .cursor = buffer,
+        .end = buffer + len,
+        .line = 0,
+    };
+}
+
+int32_t parser_tokenizer_next(ParserTokenizer* tokenizer, ParserToken* token) {
+
+    while (tokenizer->cursor < tokenizer->end) {
+
+        const char* c = tokenizer->cursor;
+        const char* end = tokenizer->end;
+
+        // Find the end of the line and move past it for the next call
+        const char* line_end = memchr(c, '\n', end - c);
+        if (!line_end) {
+            line_end = end;
+        }
+
+        tokenizer->cursor = (line_end < end) ? line_end + 1 : end;
+        tokenizer->line++;
+
+        // Comments run to the end of the line
+        const char* comment = memchr(c, '#', line_end - c);
+        if (comment) {
+            line_end = comment;
+        }
+
+        // Indentation
+        const char* start = c;
+        while (c < line_end && parser_is_space(*c)) {
+            c++;
+        }
+
+        // Empty line
+        if (c == line_end) {
+            continue;
+        }
+
+        uint32_t indent = c - start;
+
+        // Sequence item
+        bool item = false;
+        if (*c == '-' && (c + 1 == line_end || parser_is_space(c[1]))) {
+            item = true;
+
+            c++;
+            while (c < line_end && parser_is_space(*c)) {
+                c++;
+            }
+        }
+
+        uint32_t key_indent = c - start;
+
+        // Key
+        const char* key = c;
+        while (c < line_end && *c != ':' && !parser_is_space(*c)) {
+            c++;
+        }
+        const char* key_end = c;
+
+        // Items without a 'key: ' are scalars, the whole rest of the line is the value
+        if (item && (c == line_end || *c != ':' || (c + 1 < line_end && !parser_is_space(c[1])))) {
+            c = key;
+            key_end = key;
+        } else {
+            while (c < line_end && parser_is_space(*c)) {
+                c++;
+            }
+
+            if (c == line_end) {
+                printf("SYNTAX: ERROR: Token definition should end with a ':' (line %u).\n", tokenizer->line);
+                return PARSER_TOKEN_ERROR;
+            } else if (*c != ':') {
+                printf("SYNTAX: ERROR: Token name can't contain ' ' (line %u).\n", tokenizer->line);
+                return PARSER_TOKEN_ERROR;
+            } else if (key == key_end) {
+                printf("SYNTAX: ERROR: Token name can't be empty (line %u).\n", tokenizer->line);
+                return PARSER_TOKEN_ERROR;
+            }
+
+            c++;
+        }
+
+        // Value, trimmed on both sides
+        while (c < line_end && parser_is_space(*c)) {
+            c++;
+        }
+
+        const char* value_end = line_end;
+        while (value_end > c && parser_is_space(value_end[-1])) {
+            value_end--;
+        }
+
+        *token = (ParserToken) {
+            .key   = (ParserSpan) { key, key_end - key },
+            .value = (ParserSpan) { c, value_end - c },
+
+            .indent = indent,
+            .key_indent = key_indent,
+            .line = tokenizer->line,
+            .item = item,
+        };
+
+        return PARSER_TOKEN_OK;
+    }
+
+    return PARSER_TOKEN_END;
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "util/common.h"
+
+
+// Results
+#define PARSER_TOKEN_OK     0
+#define PARSER_TOKEN_END    1
+#define PARSER_TOKEN_ERROR  2
+
+// View into the tokenized buffer, not null terminated
+typedef struct ParserSpan {
+    const char* start;
+    uint32_t len;
+} ParserSpan;
+
+// A 'key: value' line, value is empty for section tags
+// Sequence items ('- value' or '- key: value') have item set, key is empty for scalar items
+typedef struct ParserToken {
+    ParserSpan key;
+    ParserSpan value;
+
+    uint32_t indent;
+    uint32_t key_indent; // Column of the key, past the '- ' for items
+    uint32_t line;
+    bool item;
+} ParserToken;
+
+// Tokenizer
+typedef struct ParserTokenizer {
+    const char* cursor;
+    const char* end;
+    uint32_t line;
+} ParserTokenizer;
+
+// Tokenizer
+void parser_tokenizer_init(ParserTokenizer* tokenizer, const char* buffer, size_t len);
+
+int32_t parser_tokenizer_next(ParserTokenizer* tokenizer, ParserToken* token);
\ No newline at end of file
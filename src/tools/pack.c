@@ -0,0 +1,19 @@
+#include "util/common.h"
+
+#include "util/pack.h"
+
+
+int main(int argc, char* argv[]) {
+
+    if (argc < 3) {
+        printf("Usage: %s <output> <file or directory>...\n", argv[0]);
+        return -1;
+    }
+
+    if (!pack_write(argv[1], (const char**) &argv[2], argc - 2)) {
+        printf("ERROR: Failed to build the resource pack '%s'.\n", argv[1]);
+        return -1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,159 @@
+#include "arena.h"
+
+
+// Block
+struct ArenaBlock {
+    struct ArenaBlock* next;
+    size_t size;
+    size_t used;
+    _Alignas(ARENA_ALIGNMENT) char data[];
+};
+
+// Scratch
+static __thread Arena scratch_;
+
+// Static
+static ArenaBlock* arena_block_new(size_t size) {
+    ArenaBlock* block = (ArenaBlock*) malloc(sizeof(ArenaBlock) + size);
+    if (!block) {
+        printf("ERROR: Failed to allocate an arena block of '%zu' bytes.\n", size);
+        abort();
+    }
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+
+    return block;
+}
+
+static void arena_free_blocks(ArenaBlock* block) {
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+}
+
+// Creation & termination
+void arena_init(Arena* arena, size_t block_size) {
+    *arena = (Arena) {
+        .first = NULL,
+        .current = NULL,
+        .block_size = block_size,
+
+        .used = 0,
+        .peak = 0,
+    };
+}
+
+void arena_free(Arena* arena) {
+    arena_free_blocks(arena->first);
+    arena_init(arena, arena->block_size);
+}
+
+// Allocation
+void* arena_alloc(Arena* arena, size_t size) {
+
+    size = (size + ARENA_ALIGNMENT - 1) & ~(size_t) (ARENA_ALIGNMENT - 1);
+    if (size == 0) {
+        size = ARENA_ALIGNMENT;
+    }
+
+    ArenaBlock* block = arena->current;
+
+    // Move on to blocks left over from before the last restore, chain a new one if none fit
+    while (!block || block->used + size > block->size) {
+
+        if (block && block->next) {
+            block = block->next;
+            block->used = 0;
+            continue;
+        }
+
+        ArenaBlock* next = arena_block_new((size > arena->block_size) ? size : arena->block_size);
+        if (block) {
+            next->next = block->next;
+            block->next = next;
+        } else {
+            arena->first = next;
+        }
+
+        block = next;
+    }
+
+    void* ptr = block->data + block->used;
+    block->used += size;
+
+    arena->current = block;
+    arena->used += size;
+    if (arena->used > arena->peak) {
+        arena->peak = arena->used;
+    }
+
+    return ptr;
+}
+
+void* arena_alloc_zero(Arena* arena, size_t size) {
+    return memset(arena_alloc(arena, size), 0, size);
+}
+
+// Release
+void arena_reset(Arena* arena) {
+
+    // Merge the chained blocks into one so the next cycle fits without chaining
+    if (arena->first && arena->first->next) {
+        size_t size = 0;
+        for (ArenaBlock* block = arena->first; block; block = block->next) {
+            size += block->size;
+        }
+
+        arena_free_blocks(arena->first);
+        arena->first = arena_block_new(size);
+    }
+
+    if (arena->first) {
+        arena->first->used = 0;
+    }
+
+    arena->current = arena->first;
+    arena->used = 0;
+}
+
+ArenaMark arena_mark(Arena* arena) {
+    return (ArenaMark) {
+        .block = arena->current,
+        .block_used = (arena->current) ? arena->current->used : 0,
+        .used = arena->used,
+    };
+}
+
+void arena_restore(Arena* arena, ArenaMark mark) {
+
+    // Marked before the first allocation
+    if (!mark.block) {
+        arena->current = arena->first;
+        if (arena->current) {
+            arena->current->used = 0;
+        }
+        arena->used = 0;
+        return;
+    }
+
+    arena->current = mark.block;
+    arena->current->used = mark.block_used;
+    arena->used = mark.used;
+}
+
+// Scratch
+Arena* arena_scratch() {
+    if (scratch_.block_size == 0) {
+        arena_init(&scratch_, ARENA_SCRATCH_BLOCK_SIZE);
+    }
+
+    return &scratch_;
+}
+
+void arena_scratch_free() {
+    arena_free(&scratch_);
+}
\ No newline at end of file
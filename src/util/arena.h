@@ -0,0 +1,55 @@
+#pragma once
+
+#include "common.h"
+
+
+// Defines
+#define ARENA_ALIGNMENT             16
+#define ARENA_SCRATCH_BLOCK_SIZE    (256 * 1024)
+
+// Block of arena memory, blocks are chained when an arena runs out
+typedef struct ArenaBlock ArenaBlock;
+
+// Linear allocator, everything is released at once by a reset or by restoring a mark
+typedef struct Arena {
+    ArenaBlock* first;
+    ArenaBlock* current;
+    size_t block_size;
+
+    size_t used; // Since the last reset
+    size_t peak;
+} Arena;
+
+// Position to roll an arena back to
+typedef struct ArenaMark {
+    ArenaBlock* block;
+    size_t block_used;
+    size_t used;
+} ArenaMark;
+
+// Allocation helpers
+#define ARENA_ALLOC(arena, type, count) \
+    ((type*) arena_alloc((arena), sizeof(type) * (count)))
+
+// Creation & termination
+void arena_init(Arena* arena, size_t block_size);
+
+void arena_free(Arena* arena);
+
+// Allocation, memory is aligned to ARENA_ALIGNMENT and uninitialized
+void* arena_alloc(Arena* arena, size_t size);
+
+void* arena_alloc_zero(Arena* arena, size_t size);
+
+// Release
+void arena_reset(Arena* arena);
+
+ArenaMark arena_mark(Arena* arena);
+
+void arena_restore(Arena* arena, ArenaMark mark);
+
+// Scratch, one arena per thread for temporaries of a single call
+// Take a mark on entry and restore it before returning
+Arena* arena_scratch();
+
+void arena_scratch_free();
\ No newline at end of file
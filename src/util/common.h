@@ -18,7 +18,8 @@
 #include <inttypes.h>
 
 // Commons
-#include "list.h"
+#include "vector.h"
+#include "heap.h"
 
 // Colors
 #define COLOR_WHITE     (vec4) {255, 255, 255, 255}
@@ -27,5 +28,5 @@
 #define COLOR_GREEN     (vec4) {0, 255, 0, 255}
 #define COLOR_BLUE      (vec4) {0, 0, 255, 255}
 
-// List declerations
-LIST_DECLARE(char);
\ No newline at end of file
+// Vector declerations
+VECTOR_DECLARE(char, 0);
\ No newline at end of file
@@ -0,0 +1,188 @@
+#include "file.h"
+
+#include "pack.h"
+
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+// Stats
+static FileStats stats_;
+static bool verbose_;
+
+// Static
+static uint64_t file_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (uint64_t) ts.tv_sec * 1000000000ULL + (uint64_t) ts.tv_nsec;
+}
+
+static void file_record(const char* path, const FileView* view, uint64_t start) {
+    uint64_t elapsed = file_time() - start;
+
+    __atomic_fetch_add(&stats_.loads, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats_.bytes, view->size, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stats_.nanoseconds, elapsed, __ATOMIC_RELAXED);
+
+    if (verbose_) {
+        const char* source = (view->packed) ? " (packed)" : (view->mapped) ? " (mapped)" : "";
+        printf("INFO: Loaded '%s', %zu bytes in %.3f ms%s.\n", path, view->size, elapsed / 1e6, source);
+    }
+}
+
+static bool file_load_packed(FileView* view, const char* path, int32_t mode) {
+    const char* data;
+    size_t size;
+
+    if (!pack_find(path, &data, &size)) {
+        return false;
+    }
+
+    // Only plain reads promise a terminator, everything else uses the archive mapping directly
+    if (mode == FILE_LOAD_READ) {
+        char* buffer = (char*) malloc(size + 1);
+        memcpy(buffer, data, size);
+        buffer[size] = '\0';
+
+        *view = (FileView) {
+            .data = buffer,
+            .size = size,
+        };
+    } else {
+        *view = (FileView) {
+            .data = data,
+            .size = size,
+            .packed = true,
+        };
+    }
+
+    return true;
+}
+
+static bool file_read_all(int32_t fd, char* buffer, size_t size) {
+    size_t done = 0;
+
+    // Regular files come back in one read, loop for the short reads pipes and signals can cause
+    while (done < size) {
+        ssize_t read_size = read(fd, buffer + done, size - done);
+        if (read_size <= 0) {
+            return false;
+        }
+
+        done += (size_t) read_size;
+    }
+
+    return true;
+}
+
+// Load & release
+bool file_load(FileView* view, const char* path, int32_t mode) {
+
+    *view = (FileView) {0};
+
+    uint64_t start = file_time();
+
+    int32_t fd;
+    if ((fd = open(path, O_RDONLY | O_CLOEXEC)) < 0) {
+        if (file_load_packed(view, path, mode)) {
+            file_record(path, view, start);
+            return true;
+        }
+
+        printf("ERROR: Could not open file at '%s'.\n", path);
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        printf("ERROR: Could not read the size of '%s'.\n", path);
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t) st.st_size;
+
+    if (mode == FILE_LOAD_AUTO) {
+        mode = (size >= FILE_MAP_THRESHOLD) ? FILE_LOAD_MAP : FILE_LOAD_READ;
+    }
+
+    // Empty files can't be mapped
+    if (mode == FILE_LOAD_MAP && size > 0) {
+        void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (data != MAP_FAILED) {
+            *view = (FileView) {
+                .data = (const char*) data,
+                .size = size,
+                .mapped = true,
+            };
+        }
+    }
+
+    // Sized from fstat, so one allocation and one read
+    if (!view->data) {
+        char* buffer = (char*) malloc(size + 1);
+
+        if (!file_read_all(fd, buffer, size)) {
+            printf("ERROR: Failed to read '%s'.\n", path);
+            free(buffer);
+            close(fd);
+            return false;
+        }
+        buffer[size] = '\0';
+
+        *view = (FileView) {
+            .data = buffer,
+            .size = size,
+            .mapped = false,
+        };
+    }
+
+    close(fd);
+
+    file_record(path, view, start);
+
+    return true;
+}
+
+void file_release(FileView* view) {
+    if (!view->data) {
+        return;
+    }
+
+    if (view->packed) {
+        // Owned by the pack
+    } else if (view->mapped) {
+        munmap((void*) view->data, view->size);
+    } else {
+        free((void*) view->data);
+    }
+
+    *view = (FileView) {0};
+}
+
+// Stats
+void file_set_verbose(bool verbose) {
+    verbose_ = verbose;
+}
+
+FileStats file_get_stats() {
+    return (FileStats) {
+        .loads = __atomic_load_n(&stats_.loads, __ATOMIC_RELAXED),
+        .bytes = __atomic_load_n(&stats_.bytes, __ATOMIC_RELAXED),
+        .nanoseconds = __atomic_load_n(&stats_.nanoseconds, __ATOMIC_RELAXED),
+    };
+}
+
+void file_print_stats(const char* label) {
+    FileStats stats = file_get_stats();
+
+    printf(
+        "INFO: %s loaded '%u' files, %.2f KB in %.3f ms.\n", 
+        label, stats.loads, stats.bytes / 1024.0, stats.nanoseconds / 1e6
+    );
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "common.h"
+
+
+// Load modes, loose files take priority over the resource pack
+#define FILE_LOAD_READ      0 // Single read into a null terminated buffer
+#define FILE_LOAD_MAP       1 // Read-only mapping or a view into the pack, not null terminated
+#define FILE_LOAD_AUTO      2 // Maps files from FILE_MAP_THRESHOLD on, packed files are never copied
+
+#define FILE_MAP_THRESHOLD  (1024 * 1024)
+
+// Read-only view of a whole file, release with file_release
+typedef struct FileView {
+    const char* data;
+    size_t size;
+    bool mapped;
+    bool packed; // Points into the resource pack, release doesn't free anything
+} FileView;
+
+// Totals over every load, updated from any thread
+typedef struct FileStats {
+    uint32_t loads;
+    uint64_t bytes;
+    uint64_t nanoseconds;
+} FileStats;
+
+// Load & release
+bool file_load(FileView* view, const char* path, int32_t mode);
+
+void file_release(FileView* view);
+
+// Stats
+void file_set_verbose(bool verbose); // Logs every load, off by default
+
+FileStats file_get_stats();
+
+void file_print_stats(const char* label);
\ No newline at end of file
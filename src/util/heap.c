@@ -0,0 +1,253 @@
+#define HEAP_NO_OVERRIDE
+#include "heap.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+// Defines
+#define HEAP_HEADER_SIZE    16 // Keeps the returned memory 16 byte aligned
+#define HEAP_MAGIC          0x48454150
+
+// Prepended to every allocation in tracking builds
+typedef struct HeapHeader {
+    uint64_t size;
+    uint32_t tag;
+    uint32_t magic;
+} HeapHeader;
+
+// Stats
+static HeapStats stats_[HEAP_TAG_COUNT];
+static HeapStats total_;
+static HeapStats gpu_;
+
+static const char* tag_names_[HEAP_TAG_COUNT] = {
+    "general",
+    "level",
+    "ui",
+    "font",
+    "parser",
+    "texture",
+};
+
+// Static
+static HeapStats heap_load(const HeapStats* stats) {
+    return (HeapStats) {
+        .allocations = __atomic_load_n(&stats->allocations, __ATOMIC_RELAXED),
+        .frees = __atomic_load_n(&stats->frees, __ATOMIC_RELAXED),
+
+        .live_bytes = __atomic_load_n(&stats->live_bytes, __ATOMIC_RELAXED),
+        .peak_bytes = __atomic_load_n(&stats->peak_bytes, __ATOMIC_RELAXED),
+    };
+}
+
+static void heap_add_bytes(HeapStats* stats, int64_t bytes) {
+    int64_t live = __atomic_add_fetch(&stats->live_bytes, bytes, __ATOMIC_RELAXED);
+
+    int64_t peak = __atomic_load_n(&stats->peak_bytes, __ATOMIC_RELAXED);
+    while (live > peak && !__atomic_compare_exchange_n(&stats->peak_bytes, &peak, live, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static int32_t heap_clamp_tag(int32_t tag) {
+    return (tag >= 0 && tag < HEAP_TAG_COUNT) ? tag : HEAP_TAG_GENERAL;
+}
+
+static void heap_count(int32_t tag, bool allocation) {
+    uint64_t* tag_counter = (allocation) ? &stats_[tag].allocations : &stats_[tag].frees;
+    uint64_t* total_counter = (allocation) ? &total_.allocations : &total_.frees;
+
+    __atomic_fetch_add(tag_counter, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(total_counter, 1, __ATOMIC_RELAXED);
+}
+
+#ifdef CTILED_MEMORY_TRACKING
+static void heap_format_bytes(char* buffer, size_t size, int64_t bytes) {
+    if (bytes >= 1024 * 1024 || bytes <= -1024 * 1024) {
+        snprintf(buffer, size, "%.2f MB", bytes / (1024.0 * 1024.0));
+    } else {
+        snprintf(buffer, size, "%.2f KB", bytes / 1024.0);
+    }
+}
+#endif
+
+// Stats
+HeapStats heap_get_stats(int32_t tag) {
+    return heap_load(&stats_[heap_clamp_tag(tag)]);
+}
+
+HeapStats heap_get_total() {
+    return heap_load(&total_);
+}
+
+HeapStats heap_get_gpu() {
+    return heap_load(&gpu_);
+}
+
+const char* heap_tag_name(int32_t tag) {
+    return tag_names_[heap_clamp_tag(tag)];
+}
+
+void heap_print_stats(const char* label) {
+    HeapStats total = heap_get_total();
+
+#ifdef CTILED_MEMORY_TRACKING
+    char live[32];
+    char peak[32];
+
+    heap_format_bytes(live, sizeof(live), total.live_bytes);
+    heap_format_bytes(peak, sizeof(peak), total.peak_bytes);
+    printf(
+        "INFO: %s heap, %s live, %s peak, '%" PRIu64 "' allocations, '%" PRIu64 "' frees.\n",
+        label, live, peak, total.allocations, total.frees
+    );
+
+    for (int32_t i = 0; i < HEAP_TAG_COUNT; ++i) {
+        HeapStats stats = heap_get_stats(i);
+        if (!stats.allocations && !stats.live_bytes) {
+            continue;
+        }
+
+        heap_format_bytes(live, sizeof(live), stats.live_bytes);
+        heap_format_bytes(peak, sizeof(peak), stats.peak_bytes);
+        printf(
+            "INFO:   %-8s %s live, %s peak, '%" PRIu64 "' allocations, '%" PRIu64 "' frees.\n",
+            heap_tag_name(i), live, peak, stats.allocations, stats.frees
+        );
+    }
+
+    HeapStats gpu = heap_get_gpu();
+    heap_format_bytes(live, sizeof(live), gpu.live_bytes);
+    heap_format_bytes(peak, sizeof(peak), gpu.peak_bytes);
+    printf("INFO:   %-8s %s live, %s peak (estimated).\n", "gpu", live, peak);
+#else
+    printf(
+        "INFO: %s heap, '%" PRIu64 "' allocations, '%" PRIu64 "' frees.\n",
+        label, total.allocations, total.frees
+    );
+#endif
+}
+
+// Memory allocated outside of the project's own calls
+void heap_track(int32_t tag, int64_t bytes) {
+#ifdef CTILED_MEMORY_TRACKING
+    heap_add_bytes(&stats_[heap_clamp_tag(tag)], bytes);
+    heap_add_bytes(&total_, bytes);
+#else
+    (void) tag;
+    (void) bytes;
+#endif
+}
+
+void heap_track_gpu(int64_t bytes) {
+    heap_add_bytes(&gpu_, bytes);
+}
+
+#if defined(DEBUG) || defined(CTILED_MEMORY_TRACKING)
+
+#ifdef CTILED_MEMORY_TRACKING
+
+static void* heap_attach(HeapHeader* header, size_t size, int32_t tag) {
+    if (!header) {
+        return NULL;
+    }
+
+    header->size = size;
+    header->tag = tag;
+    header->magic = HEAP_MAGIC;
+
+    heap_track(tag, (int64_t) size);
+
+    return (char*) header + HEAP_HEADER_SIZE;
+}
+
+static HeapHeader* heap_detach(void* ptr) {
+    HeapHeader* header = (HeapHeader*) ((char*) ptr - HEAP_HEADER_SIZE);
+
+    if (header->magic != HEAP_MAGIC) {
+        printf("ERROR: Pointer '%p' was not allocated by the heap tracker.\n", ptr);
+        abort();
+    }
+
+    heap_track(header->tag, -(int64_t) header->size);
+    header->magic = 0;
+
+    return header;
+}
+
+void* heap_malloc(size_t size, int32_t tag) {
+    tag = heap_clamp_tag(tag);
+    heap_count(tag, true);
+
+    return heap_attach((HeapHeader*) malloc(HEAP_HEADER_SIZE + size), size, tag);
+}
+
+void* heap_calloc(size_t count, size_t size, int32_t tag) {
+    tag = heap_clamp_tag(tag);
+    heap_count(tag, true);
+
+    return heap_attach((HeapHeader*) calloc(1, HEAP_HEADER_SIZE + count * size), count * size, tag);
+}
+
+void* heap_realloc(void* ptr, size_t size, int32_t tag) {
+    if (!ptr) {
+        return heap_malloc(size, tag);
+    }
+
+    // Keeps the tag of the original allocation
+    HeapHeader* header = heap_detach(ptr);
+    tag = header->tag;
+    heap_count(tag, false);
+    heap_count(tag, true);
+
+    HeapHeader* resized = (HeapHeader*) realloc(header, HEAP_HEADER_SIZE + size);
+    if (!resized) {
+        heap_attach(header, header->size, tag);
+        return NULL;
+    }
+
+    return heap_attach(resized, size, tag);
+}
+
+void heap_free(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    HeapHeader* header = heap_detach(ptr);
+    heap_count(header->tag, false);
+
+    free(header);
+}
+
+#else
+
+void* heap_malloc(size_t size, int32_t tag) {
+    heap_count(heap_clamp_tag(tag), true);
+    return malloc(size);
+}
+
+void* heap_calloc(size_t count, size_t size, int32_t tag) {
+    heap_count(heap_clamp_tag(tag), true);
+    return calloc(count, size);
+}
+
+void* heap_realloc(void* ptr, size_t size, int32_t tag) {
+    if (ptr) {
+        heap_count(HEAP_TAG_GENERAL, false);
+    }
+    heap_count(heap_clamp_tag(tag), true);
+    return realloc(ptr, size);
+}
+
+void heap_free(void* ptr) {
+    // Without a header the tag of the pointer is unknown
+    if (ptr) {
+        heap_count(HEAP_TAG_GENERAL, false);
+    }
+    free(ptr);
+}
+
+#endif
+
+#endif
\ No newline at end of file
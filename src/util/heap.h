@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+
+// Subsystem tags, a source file picks its tag by defining HEAP_TAG before its first include
+#define HEAP_TAG_GENERAL    0
+#define HEAP_TAG_LEVEL      1
+#define HEAP_TAG_UI         2
+#define HEAP_TAG_FONT       3
+#define HEAP_TAG_PARSER     4
+#define HEAP_TAG_TEXTURE    5 // CPU side staging of decoded images
+#define HEAP_TAG_COUNT      6
+
+#ifndef HEAP_TAG
+#define HEAP_TAG HEAP_TAG_GENERAL
+#endif
+
+// Calls are counted in debug and tracking builds, bytes only with CTILED_MEMORY_TRACKING
+typedef struct HeapStats {
+    uint64_t allocations; // malloc, calloc and realloc calls
+    uint64_t frees; // free calls, a realloc of an existing block counts as both
+
+    int64_t live_bytes;
+    int64_t peak_bytes;
+} HeapStats;
+
+// Stats
+HeapStats heap_get_stats(int32_t tag);
+
+HeapStats heap_get_total();
+
+HeapStats heap_get_gpu(); // Estimated, only bytes are kept
+
+const char* heap_tag_name(int32_t tag);
+
+void heap_print_stats(const char* label);
+
+// Memory allocated outside of the project's own calls, like decoded images
+void heap_track(int32_t tag, int64_t bytes);
+
+void heap_track_gpu(int64_t bytes);
+
+#if defined(DEBUG) || defined(CTILED_MEMORY_TRACKING)
+
+void* heap_malloc(size_t size, int32_t tag);
+
+void* heap_calloc(size_t count, size_t size, int32_t tag);
+
+void* heap_realloc(void* ptr, size_t size, int32_t tag);
+
+void heap_free(void* ptr);
+
+// Route the project's own calls through the counters, vendored and library code is not counted
+#ifndef HEAP_NO_OVERRIDE
+#define malloc(size)            heap_malloc(size, HEAP_TAG)
+#define calloc(count, size)     heap_calloc(count, size, HEAP_TAG)
+#define realloc(ptr, size)      heap_realloc(ptr, size, HEAP_TAG)
+#define free(ptr)               heap_free(ptr)
+#endif
+
+#endif
\ No newline at end of file
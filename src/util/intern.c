@@ -0,0 +1,146 @@
+#include "intern.h"
+
+#include "util.h"
+
+
+// Defines
+#define INTERN_BLOCK_SIZE       4096
+#define INTERN_DEFAULT_CAPACITY 64
+
+// Storage block, strings are never moved once interned
+typedef struct InternBlock {
+    struct InternBlock* next;
+    uint32_t used;
+    uint32_t capacity;
+    char data[];
+} InternBlock;
+
+typedef struct InternEntry {
+    const char* str;
+    uint32_t len;
+    uint64_t hash;
+} InternEntry;
+
+// Pool
+static InternEntry* entries_;
+static uint32_t count_;
+static uint32_t capacity_;
+
+static InternBlock* blocks_;
+
+// Static
+static char* intern_alloc(uint32_t size) {
+    if (!blocks_ || blocks_->capacity - blocks_->used < size) {
+        uint32_t capacity = (size > INTERN_BLOCK_SIZE) ? size : INTERN_BLOCK_SIZE;
+
+        InternBlock* block = (InternBlock*) malloc(sizeof(InternBlock) + capacity);
+        block->next = blocks_;
+        block->used = 0;
+        block->capacity = capacity;
+
+        blocks_ = block;
+    }
+
+    char* ptr = blocks_->data + blocks_->used;
+    blocks_->used += size;
+
+    return ptr;
+}
+
+static void intern_grow() {
+    uint32_t capacity = (capacity_) ? capacity_ * 2 : INTERN_DEFAULT_CAPACITY;
+    InternEntry* entries = (InternEntry*) calloc(capacity, sizeof(InternEntry));
+
+    for (uint32_t i = 0; i < capacity_; ++i) {
+        InternEntry* entry = &entries_[i];
+        if (!entry->str) {
+            continue;
+        }
+
+        uint32_t slot = entry->hash & (capacity - 1);
+        while (entries[slot].str) {
+            slot = (slot + 1) & (capacity - 1);
+        }
+        entries[slot] = *entry;
+    }
+
+    free(entries_);
+
+    entries_ = entries;
+    capacity_ = capacity;
+}
+
+static uint32_t intern_find_slot(const char* str, uint32_t len, uint64_t hash) {
+    uint32_t slot = hash & (capacity_ - 1);
+
+    while (entries_[slot].str) {
+        InternEntry* entry = &entries_[slot];
+
+        if (entry->hash == hash && entry->len == len && memcmp(entry->str, str, len) == STR_EQUAL) {
+            break;
+        }
+
+        slot = (slot + 1) & (capacity_ - 1);
+    }
+
+    return slot;
+}
+
+// Interning
+uint64_t intern_hash(const char* str, uint32_t len) {
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (uint32_t i = 0; i < len; ++i) {
+        hash ^= (uint8_t) str[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+const char* intern_string(const char* str, uint32_t len) {
+    return intern_string_hashed(str, len, intern_hash(str, len));
+}
+
+const char* intern_string_hashed(const char* str, uint32_t len, uint64_t hash) {
+
+    // Strings already in the pool never trigger a grow
+    uint32_t slot = (capacity_) ? intern_find_slot(str, len, hash) : 0;
+    if (capacity_ && entries_[slot].str) {
+        return entries_[slot].str;
+    }
+
+    // Keep the load factor under 3/4
+    if ((count_ + 1) * 4 > capacity_ * 3) {
+        intern_grow();
+        slot = intern_find_slot(str, len, hash);
+    }
+
+    char* copy = intern_alloc(len + 1);
+    memcpy(copy, str, len);
+    copy[len] = '\0';
+
+    entries_[slot] = (InternEntry) {
+        .str = copy,
+        .len = len,
+        .hash = hash,
+    };
+    count_++;
+
+    return copy;
+}
+
+void intern_free() {
+    while (blocks_) {
+        InternBlock* next = blocks_->next;
+        free(blocks_);
+        blocks_ = next;
+    }
+
+    free(entries_);
+
+    entries_ = NULL;
+    count_ = 0;
+    capacity_ = 0;
+}
\ No newline at end of file
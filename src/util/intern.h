@@ -0,0 +1,14 @@
+#pragma once
+
+#include "common.h"
+
+
+// Interned strings live until intern_free, equal strings share one pointer
+// Single-threaded, the pool isn't locked, so intern from the main thread only
+uint64_t intern_hash(const char* str, uint32_t len);
+
+const char* intern_string(const char* str, uint32_t len);
+
+const char* intern_string_hashed(const char* str, uint32_t len, uint64_t hash);
+
+void intern_free();
\ No newline at end of file
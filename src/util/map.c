@@ -1,105 +1,117 @@
 #include "map.h"
 
+#include "intern.h"
+
+// Static
+static MapEntry* map_find_slot(MapEntry* entries, uint32_t capacity, const char* key, uint32_t key_len, uint64_t hash) {
+    uint32_t slot = hash & (capacity - 1);
+
+    while (entries[slot].key) {
+        MapEntry* entry = &entries[slot];
+
+        if (entry->hash == hash && entry->key_len == key_len && 
+            (entry->key == key || memcmp(entry->key, key, key_len) == STR_EQUAL)) {
+            break;
+        }
+
+        slot = (slot + 1) & (capacity - 1);
+    }
+
+    return &entries[slot];
+}
+
+static void map_grow(Map* map) {
+    uint32_t capacity = map->capacity_ * 2;
+    MapEntry* entries = (MapEntry*) calloc(capacity, sizeof(MapEntry));
+
+    for (uint32_t i = 0; i < map->capacity_; ++i) {
+        MapEntry* entry = &map->entries_[i];
+        if (!entry->key) {
+            continue;
+        }
+
+        *map_find_slot(entries, capacity, entry->key, entry->key_len, entry->hash) = *entry;
+    }
+
+    free(map->entries_);
+
+    map->entries_ = entries;
+    map->capacity_ = capacity;
+}
+
 Map map_new() {
-    const uint32_t default_size = 2;
+    const uint32_t default_size = 16;
 
     Map m = (Map) {
-        .keys_   = (char**) calloc(default_size, sizeof(char*)),
-        .values_ = (char**) calloc(default_size, sizeof(char*)),
+        .entries_ = (MapEntry*) calloc(default_size, sizeof(MapEntry)),
 
         .count_ = 0,
-        .capacity_ = 2,
+        .capacity_ = default_size,
     };
 
     return m;
 }
 
 void map_free(Map* map) {
-    for (uint32_t i = 0; i < map->count_; ++i) {
-        free(map->keys_[i]);
-        free(map->values_[i]);
+    // Keys belong to the intern pool
+    for (uint32_t i = 0; i < map->capacity_; ++i) {
+        free(map->entries_[i].value);
     }
 
-    free(map->keys_);
-    free(map->values_);
+    free(map->entries_);
 
+    map->entries_ = NULL;
     map->count_ = 0;
     map->capacity_ = 0;
 }
 
-const char* map_get_key(Map* map, const char* key) {
-    char* value_ = NULL;
+uint64_t map_hash(const char* key, uint32_t key_len) {
+    return intern_hash(key, key_len);
+}
 
-    for (uint32_t index = 0; index < map->count_; ++index) {
-        char* key_ = map->keys_[index];
-        
-        if (strcmp(key_, key) == STR_EQUAL) {
-            value_ = map->values_[index];
-            break;
-        }
-    }
-    
-    return value_;
+const char* map_get_key(Map* map, const char* key) {
+    uint32_t key_len = strlen(key);
+    return map_get_key_hashed(map, key, key_len, map_hash(key, key_len));
 }
 
-ValuePair map_get_key_pair(Map* map, const char* key) {
-    char* value_ = NULL;
-    uint32_t index_ = 0;
+const char* map_get_key_hashed(Map* map, const char* key, uint32_t key_len, uint64_t hash) {
+    return map_find_slot(map->entries_, map->capacity_, key, key_len, hash)->value;
+}
 
-    for (uint32_t index = 0; index < map->count_; ++index) {
-        char* key_ = map->keys_[index];
-        
-        if (strcmp(key_, key) == STR_EQUAL) {
-            value_ = map->values_[index];
-            index_ = index;
-            break;
-        }
-    }
+void map_set_key(Map* map, const char* key, const char* value) {
+    map_set_key_len(map, key, strlen(key), value, strlen(value));
+}
 
-    return (ValuePair) { 
-        .value = value_,
-        .index = index_,
-    };
+void map_set_key_len(Map* map, const char* key, uint32_t key_len, const char* value, uint32_t value_len) {
+    map_set_key_hashed(map, key, key_len, map_hash(key, key_len), value, value_len);
 }
 
-void map_set_key(Map* map, const char* key, const char* value) {
-    ValuePair pair = map_get_key_pair(map, key);
-    
-    if (pair.value) {
-        size_t len = strlen(value);
-        if (len <= 0) {
-            free(map->values_[pair.index]);
-            
-            map->values_[pair.index] = (char*) calloc(1, sizeof(char));
-            return;
-        } else {
-            free(map->values_[pair.index]);
-
-            char* str = (char*) calloc(len + 1, sizeof(char));
-            map->values_[pair.index] = strcpy(str, value);
-            return;
-        }
-    }
+void map_set_key_hashed(Map* map, const char* key, uint32_t key_len, uint64_t hash, const char* value, uint32_t value_len) {
 
-    if (map->count_ == map->capacity_) {
-        map->capacity_ *= 2;
-        uint32_t size = map->capacity_ * sizeof(char*);
+    // Copy the value, the sources don't have to be null terminated
+    char* cvalue = (char*) calloc(value_len + 1, sizeof(char));
+    memcpy(cvalue, value, value_len);
 
-        map->keys_   = (char**) realloc(map->keys_,   size);
-        map->values_ = (char**) realloc(map->values_, size);
+    MapEntry* entry = map_find_slot(map->entries_, map->capacity_, key, key_len, hash);
+
+    if (entry->key) {
+        free(entry->value);
+        entry->value = cvalue;
+        return;
     }
 
-    uint32_t current = map->count_++;
+    // Only a new key can push the load factor over 3/4
+    if ((map->count_ + 1) * 4 > map->capacity_ * 3) {
+        map_grow(map);
+        entry = map_find_slot(map->entries_, map->capacity_, key, key_len, hash);
+    }
 
-    size_t len = strlen(key);
-    char* ckey = (char*) calloc(len + 1, sizeof(char));
-    map->keys_[current] = strcpy(ckey, key);
+    *entry = (MapEntry) {
+        .key = intern_string_hashed(key, key_len, hash),
+        .key_len = key_len,
+        .hash = hash,
 
-    len = strlen(value);
-    if (len <= 0) {
-        map->values_[current] = (char*) calloc(1, sizeof(char));;
-    } else {
-        char* cvalue = (char*) calloc(len + 1, sizeof(char));
-        map->values_[current] = strcpy(cvalue, value);
-    }
+        .value = cvalue,
+    };
+    map->count_++;
 }
\ No newline at end of file
@@ -3,23 +3,34 @@
 #include "common.h"
 #include "util.h"
 
+// Slot of the open addressing table, key is NULL for empty slots
+typedef struct MapEntry {
+    const char* key; // Interned
+    uint32_t key_len;
+    uint64_t hash;
+
+    char* value;
+} MapEntry;
+
 typedef struct Map {
-    char** keys_;
-    char** values_;
+    MapEntry* entries_;
 
     uint32_t count_;
-    uint32_t capacity_;
+    uint32_t capacity_; // Power of two
 } Map;
 
-typedef struct ValuePair {
-    char* value;
-    uint32_t index;
-} ValuePair;
-
 Map map_new();
 
 void map_free(Map* map);
 
+uint64_t map_hash(const char* key, uint32_t key_len);
+
 const char* map_get_key(Map* map, const char* key);
 
-void map_set_key(Map* map, const char* key, const char* value);
\ No newline at end of file
+const char* map_get_key_hashed(Map* map, const char* key, uint32_t key_len, uint64_t hash);
+
+void map_set_key(Map* map, const char* key, const char* value);
+
+void map_set_key_len(Map* map, const char* key, uint32_t key_len, const char* value, uint32_t value_len);
+
+void map_set_key_hashed(Map* map, const char* key, uint32_t key_len, uint64_t hash, const char* value, uint32_t value_len);
\ No newline at end of file
@@ -0,0 +1,334 @@
+#include "pack.h"
+
+#include "util.h"
+#include "file.h"
+#include "intern.h"
+
+#include <dirent.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+
+// Archive, mapped once and kept for the lifetime of the program
+static FileView archive_;
+static const PackEntry* entries_;
+static uint32_t entry_count_;
+
+// Formats the game loads, anything else found in a directory is a source file (.aseprite, ...) and stays out
+static const char* pack_extensions_[] = {
+    ".png", ".jpg", ".jpeg", ".ttf", ".vert", ".frag", ".yaml", ".level", ".tmx", ".tmj", ".json", ".csv",
+};
+
+// Entries collected while building
+typedef struct PackSource {
+    char* name;
+    uint64_t hash;
+    uint64_t size;
+} PackSource;
+
+typedef struct PackBuilder {
+    PackSource* sources;
+    uint32_t count;
+    uint32_t capacity;
+} PackBuilder;
+
+// Static
+static const char* pack_normalize(const char* name) {
+    while (name[0] == '.' && name[1] == '/') {
+        name += 2;
+    }
+
+    return name;
+}
+
+static void pack_add_source(PackBuilder* builder, const char* path, uint64_t size) {
+    if (builder->count == builder->capacity) {
+        builder->capacity = (builder->capacity) ? builder->capacity * 2 : 64;
+        builder->sources = (PackSource*) realloc(builder->sources, sizeof(PackSource) * builder->capacity);
+    }
+
+    const char* name = pack_normalize(path);
+
+    char* copy = (char*) calloc(strlen(name) + 1, sizeof(char));
+    strcpy(copy, name);
+
+    builder->sources[builder->count++] = (PackSource) {
+        .name = copy,
+        .hash = intern_hash(copy, strlen(copy)),
+        .size = size,
+    };
+}
+
+static bool pack_loadable(const char* path) {
+    const char* extension = strrchr(path, '.');
+    if (!extension || strchr(extension, '/')) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < sizeof(pack_extensions_) / sizeof(pack_extensions_[0]); ++i) {
+        if (strcasecmp(extension, pack_extensions_[i]) == STR_EQUAL) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool pack_collect(PackBuilder* builder, const char* path, bool listed) {
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        printf("ERROR: Pack input '%s' doesn't exist.\n", path);
+        return false;
+    }
+
+    if (!S_ISDIR(st.st_mode)) {
+
+        // Files given by name are always packed, the filter is for what directories happen to contain
+        if (!listed && !pack_loadable(path)) {
+            printf("INFO: Skipping '%s', the game doesn't load it.\n", path);
+            return true;
+        }
+
+        pack_add_source(builder, path, (uint64_t) st.st_size);
+        return true;
+    }
+
+    DIR* dir = opendir(path);
+    if (!dir) {
+        printf("ERROR: Directory '%s' could not be opened.\n", path);
+        return false;
+    }
+
+    bool success = true;
+
+    struct dirent* entry;
+    while (success && (entry = readdir(dir))) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        char child[1024];
+        snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+
+        success = pack_collect(builder, child, false);
+    }
+
+    closedir(dir);
+
+    return success;
+}
+
+static int pack_compare_sources(const void* a, const void* b) {
+    const PackSource* sa = (const PackSource*) a;
+    const PackSource* sb = (const PackSource*) b;
+
+    if (sa->hash != sb->hash) {
+        return (sa->hash < sb->hash) ? -1 : 1;
+    }
+
+    return strcmp(sa->name, sb->name);
+}
+
+static uint64_t pack_align(uint64_t value) {
+    return (value + PACK_ALIGNMENT - 1) & ~(uint64_t) (PACK_ALIGNMENT - 1);
+}
+
+static void pack_write_padding(FILE* file, uint64_t from, uint64_t to) {
+    static const char zeros[PACK_ALIGNMENT] = {0};
+    fwrite(zeros, 1, to - from, file);
+}
+
+// Archive
+bool pack_open(const char* path) {
+
+    struct stat st;
+    if (stat(path, &st) != 0) {
+        return false;
+    }
+
+    if (!file_load(&archive_, path, FILE_LOAD_MAP)) {
+        return false;
+    }
+
+    const PackHeader* header = (const PackHeader*) archive_.data;
+
+    if (archive_.size < sizeof(PackHeader) || memcmp(header->magic, PACK_MAGIC, 4) != STR_EQUAL || header->version != PACK_VERSION ||
+        sizeof(PackHeader) + (uint64_t) header->entry_count * sizeof(PackEntry) > archive_.size) {
+        printf("ERROR: '%s' is not a valid resource pack.\n", path);
+        pack_close();
+        return false;
+    }
+
+    // Every name and file has to lie inside the archive, and the index has to be sorted for pack_find
+    const PackEntry* entries = (const PackEntry*) (archive_.data + sizeof(PackHeader));
+    uint64_t archive_size = archive_.size;
+
+    for (uint32_t i = 0; i < header->entry_count; ++i) {
+        const PackEntry* entry = &entries[i];
+
+        bool valid = (uint64_t) entry->name_offset + entry->name_len <= archive_size && 
+                     entry->offset <= archive_size && entry->size <= archive_size - entry->offset && 
+                     (i == 0 || entries[i - 1].hash <= entry->hash);
+
+        if (!valid) {
+            printf("ERROR: Resource pack '%s' is corrupt, entry '%u' is out of range.\n", path, i);
+            pack_close();
+            return false;
+        }
+    }
+
+    entries_ = entries;
+    entry_count_ = header->entry_count;
+
+    printf("INFO: Mounted resource pack '%s' with '%u' files.\n", path, entry_count_);
+
+    return true;
+}
+
+void pack_close() {
+    file_release(&archive_);
+
+    entries_ = NULL;
+    entry_count_ = 0;
+}
+
+bool pack_find(const char* name, const char** data, size_t* size) {
+    if (!entry_count_) {
+        return false;
+    }
+
+    name = pack_normalize(name);
+
+    uint32_t len = strlen(name);
+    uint64_t hash = intern_hash(name, len);
+
+    // Lower bound of the hash, equal hashes are checked by name
+    uint32_t low = 0;
+    uint32_t high = entry_count_;
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+
+        if (entries_[mid].hash < hash) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    for (uint32_t i = low; i < entry_count_ && entries_[i].hash == hash; ++i) {
+        const PackEntry* entry = &entries_[i];
+
+        if (entry->name_len == len && memcmp(archive_.data + entry->name_offset, name, len) == STR_EQUAL) {
+            *data = archive_.data + entry->offset;
+            *size = entry->size;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Build
+bool pack_write(const char* path, const char** inputs, uint32_t input_count) {
+
+    PackBuilder builder = {0};
+
+    bool success = true;
+    for (uint32_t i = 0; i < input_count && success; ++i) {
+        success = pack_collect(&builder, inputs[i], true);
+    }
+
+    FILE* file = NULL;
+    if (success && !(file = fopen(path, "wb"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        success = false;
+    }
+
+    if (success) {
+
+        // Sorted by hash so lookups can binary search the mapped index
+        qsort(builder.sources, builder.count, sizeof(PackSource), pack_compare_sources);
+
+        uint64_t names_offset = sizeof(PackHeader) + (uint64_t) builder.count * sizeof(PackEntry);
+        uint64_t names_size = 0;
+        for (uint32_t i = 0; i < builder.count; ++i) {
+            names_size += strlen(builder.sources[i].name) + 1;
+        }
+
+        PackHeader header = {0};
+        memcpy(header.magic, PACK_MAGIC, 4);
+        header.version = PACK_VERSION;
+        header.entry_count = builder.count;
+        header.names_offset = (uint32_t) names_offset;
+
+        fwrite(&header, sizeof(PackHeader), 1, file);
+
+        // Sizes come from the collect pass, the data is checked against them below
+        uint64_t name_cursor = names_offset;
+        uint64_t data_cursor = pack_align(names_offset + names_size);
+
+        for (uint32_t i = 0; i < builder.count; ++i) {
+            uint32_t name_len = strlen(builder.sources[i].name);
+
+            PackEntry entry = (PackEntry) {
+                .hash = builder.sources[i].hash,
+                .name_offset = (uint32_t) name_cursor,
+                .name_len = name_len,
+                .offset = data_cursor,
+                .size = builder.sources[i].size,
+            };
+            fwrite(&entry, sizeof(PackEntry), 1, file);
+
+            name_cursor += name_len + 1;
+            data_cursor = pack_align(data_cursor + entry.size);
+        }
+
+        for (uint32_t i = 0; i < builder.count; ++i) {
+            fwrite(builder.sources[i].name, 1, strlen(builder.sources[i].name) + 1, file);
+        }
+
+        uint64_t cursor = names_offset + names_size;
+        pack_write_padding(file, cursor, pack_align(cursor));
+        cursor = pack_align(cursor);
+
+        uint64_t total = 0;
+        for (uint32_t i = 0; i < builder.count && success; ++i) {
+            FileView view;
+            if (!file_load(&view, builder.sources[i].name, FILE_LOAD_AUTO)) {
+                success = false;
+                break;
+            }
+
+            if (view.size != builder.sources[i].size) {
+                printf("ERROR: '%s' changed while packing.\n", builder.sources[i].name);
+                file_release(&view);
+                success = false;
+                break;
+            }
+
+            fwrite(view.data, 1, view.size, file);
+            pack_write_padding(file, cursor + view.size, pack_align(cursor + view.size));
+
+            cursor = pack_align(cursor + view.size);
+            total += view.size;
+
+            file_release(&view);
+        }
+
+        if (fclose(file) != 0) {
+            printf("ERROR: Failed to write '%s'.\n", path);
+            success = false;
+        }
+
+        if (success) {
+            printf("INFO: Packed '%u' files, %.2f KB into '%s'.\n", builder.count, total / 1024.0, path);
+        }
+    }
+
+    for (uint32_t i = 0; i < builder.count; ++i) {
+        free(builder.sources[i].name);
+    }
+    free(builder.sources);
+
+    return success;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "common.h"
+
+
+// Defines
+#define PACK_DEFAULT_PATH   "res.pak"
+#define PACK_MAGIC          "CTPK"
+#define PACK_VERSION        1
+#define PACK_ALIGNMENT      16
+
+// Archive layout, little endian: header, entries sorted by hash, names, then the file data
+typedef struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t names_offset;
+} PackHeader;
+
+typedef struct PackEntry {
+    uint64_t hash; // FNV-1a of the name
+    uint32_t name_offset;
+    uint32_t name_len;
+    uint64_t offset;
+    uint64_t size;
+} PackEntry;
+
+// Archive
+bool pack_open(const char* path);
+
+void pack_close();
+
+bool pack_find(const char* name, const char** data, size_t* size);
+
+// Build, inputs are files or directories, entries are named by their path as given
+// Files inside directories are only packed in formats the game loads
+bool pack_write(const char* path, const char** inputs, uint32_t input_count);
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "png.h"
+
+#include <zlib.h>
+
+
+// Static
+static void png_put_u32(uint8_t* buffer, uint32_t value) {
+    buffer[0] = (uint8_t) (value >> 24);
+    buffer[1] = (uint8_t) (value >> 16);
+    buffer[2] = (uint8_t) (value >> 8);
+    buffer[3] = (uint8_t) (value);
+}
+
+// Length, type, data and a crc over the type and data
+static void png_write_chunk(FILE* file, const char* type, const uint8_t* data, uint32_t size) {
+
+    uint8_t header[8];
+    png_put_u32(header, size);
+    memcpy(header + 4, type, 4);
+
+    uLong crc = crc32(0, (const Bytef*) type, 4);
+    if (size) {
+        crc = crc32(crc, data, size);
+    }
+
+    uint8_t footer[4];
+    png_put_u32(footer, (uint32_t) crc);
+
+    fwrite(header, 1, sizeof(header), file);
+    if (size) {
+        fwrite(data, 1, size, file);
+    }
+    fwrite(footer, 1, sizeof(footer), file);
+}
+
+// Writing
+bool png_write(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height, bool flip_y) {
+
+    // Scanlines, each prefixed with its filter type
+    size_t stride = (size_t) width * 4;
+    size_t raw_size = (stride + 1) * height;
+    uint8_t* raw = (uint8_t*) malloc(raw_size);
+
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* row = pixels + stride * ((flip_y) ? height - 1 - y : y);
+        uint8_t* line = raw + (stride + 1) * y;
+
+        // Sub filter, neighbouring pixels of a frame are mostly equal
+        line[0] = 1;
+        for (size_t x = 0; x < stride; ++x) {
+            line[x + 1] = row[x] - ((x >= 4) ? row[x - 4] : 0);
+        }
+    }
+
+    uLongf compressed_size = compressBound(raw_size);
+    uint8_t* compressed = (uint8_t*) malloc(compressed_size);
+
+    int result = compress2(compressed, &compressed_size, raw, raw_size, Z_DEFAULT_COMPRESSION);
+    free(raw);
+
+    if (result != Z_OK) {
+        printf("ERROR: Failed to compress '%s'.\n", path);
+        free(compressed);
+        return false;
+    }
+
+    FILE* file;
+    if (!(file = fopen(path, "wb"))) {
+        printf("ERROR: File '%s' could not be opened.\n", path);
+        free(compressed);
+        return false;
+    }
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    fwrite(signature, 1, sizeof(signature), file);
+
+    // 8 bit RGBA, no interlacing
+    uint8_t header[13] = {0};
+    png_put_u32(header, width);
+    png_put_u32(header + 4, height);
+    header[8] = 8;
+    header[9] = 6;
+
+    png_write_chunk(file, "IHDR", header, sizeof(header));
+    png_write_chunk(file, "IDAT", compressed, (uint32_t) compressed_size);
+    png_write_chunk(file, "IEND", NULL, 0);
+
+    free(compressed);
+
+    if (fclose(file) != 0) {
+        printf("ERROR: Failed to write '%s'.\n", path);
+        return false;
+    }
+
+    return true;
+}
\ No newline at end of file
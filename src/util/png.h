@@ -0,0 +1,7 @@
+#pragma once
+
+#include "common.h"
+
+
+// Writes 8 bit RGBA pixels, flip_y writes the rows bottom up as glReadPixels returns them
+bool png_write(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height, bool flip_y);
\ No newline at end of file
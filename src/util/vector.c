@@ -0,0 +1,127 @@
+#include "vector.h"
+#include "heap.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+// Static
+static void* vector_realloc(VectorBase* vec, void* ptr, size_t old_size, size_t new_size) {
+    if (vec->allocator) {
+        return vec->allocator->reallocate(vec->allocator->user, ptr, old_size, new_size);
+    }
+
+    return realloc(ptr, new_size);
+}
+
+static void vector_release(VectorBase* vec, void* ptr, size_t size) {
+    if (vec->allocator) {
+        vec->allocator->release(vec->allocator->user, ptr, size);
+    } else {
+        free(ptr);
+    }
+}
+
+static void vector_resize(VectorBase* vec, void* storage, size_t item_size, uint32_t capacity) {
+
+    // Back into the inline storage
+    if (capacity <= vec->inline_capacity) {
+        if (vec->array != storage) {
+            memcpy(storage, vec->array, item_size * vec->count);
+            vector_release(vec, vec->array, item_size * vec->capacity);
+
+            vec->array = storage;
+            vec->capacity = vec->inline_capacity;
+        }
+        return;
+    }
+
+    // Out of the inline storage, the old elements have to be copied by hand
+    bool moving = (vec->array == storage);
+    void* array = (moving) ? 
+        vector_realloc(vec, NULL, 0, item_size * capacity) : 
+        vector_realloc(vec, vec->array, item_size * vec->capacity, item_size * capacity);
+
+    if (!array) {
+        printf("ERROR: Failed to allocate a vector of '%u' elements.\n", capacity);
+        abort();
+    }
+
+    if (moving) {
+        memcpy(array, storage, item_size * vec->count);
+    }
+
+    vec->array = array;
+    vec->capacity = capacity;
+}
+
+// Initialization & termination
+void vector_init_(VectorBase* vec, void* storage, uint32_t inline_capacity, const VectorAllocator* allocator) {
+    *vec = (VectorBase) {
+        .array = (inline_capacity) ? storage : NULL,
+        .count = 0,
+        .capacity = inline_capacity,
+        .inline_capacity = inline_capacity,
+        .allocator = allocator,
+    };
+}
+
+void vector_free_(VectorBase* vec, void* storage, size_t item_size) {
+    if (vec->array && vec->array != storage) {
+        vector_release(vec, vec->array, item_size * vec->capacity);
+    }
+
+    vec->array = (vec->inline_capacity) ? storage : NULL;
+    vec->count = 0;
+    vec->capacity = vec->inline_capacity;
+}
+
+// Capacity
+void vector_reserve_(VectorBase* vec, void* storage, size_t item_size, uint32_t capacity) {
+    if (capacity <= vec->capacity) {
+        return;
+    }
+
+    // At least double, so repeated pushes stay amortized constant
+    uint32_t doubled = (vec->capacity) ? vec->capacity * 2 : 8;
+    vector_resize(vec, storage, item_size, (capacity > doubled) ? capacity : doubled);
+}
+
+void vector_shrink_(VectorBase* vec, void* storage, size_t item_size) {
+    if (vec->array == storage || vec->count == vec->capacity) {
+        return;
+    }
+
+    if (vec->count == 0 && vec->inline_capacity == 0) {
+        vector_release(vec, vec->array, item_size * vec->capacity);
+
+        vec->array = NULL;
+        vec->capacity = 0;
+        return;
+    }
+
+    vector_resize(vec, storage, item_size, vec->count);
+}
+
+// Functionality
+void vector_append_(VectorBase* vec, void* storage, size_t item_size, const void* items, uint32_t count) {
+    if (!count) {
+        return;
+    }
+
+    vector_reserve_(vec, storage, item_size, vec->count + count);
+
+    memcpy((char*) vec->array + item_size * vec->count, items, item_size * count);
+    vec->count += count;
+}
+
+void vector_remove_(VectorBase* vec, size_t item_size, uint32_t index) {
+    if (index >= vec->count) {
+        return;
+    }
+
+    char* ptr = (char*) vec->array + item_size * index;
+    memmove(ptr, ptr + item_size, item_size * (vec->count - index - 1));
+
+    vec->count--;
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+
+// Allocator, NULL uses the C heap
+typedef struct VectorAllocator {
+    void* (*reallocate)(void* user, void* ptr, size_t old_size, size_t new_size);
+    void (*release)(void* user, void* ptr, size_t size);
+    void* user;
+} VectorAllocator;
+
+// Type erased layout shared by every vector
+typedef struct VectorBase {
+    void* array;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t inline_capacity;
+    const VectorAllocator* allocator;
+} VectorBase;
+
+// Decleration, the first inline_count elements live inside the vector itself
+// so a vector with inline storage must not be copied by value
+#define VECTOR_DECLARE_NAMED(name, type, inline_count) \
+    typedef struct name { \
+        type* array; \
+        uint32_t count; \
+        uint32_t capacity; \
+        uint32_t inline_capacity; \
+        const VectorAllocator* allocator; \
+        type inline_[inline_count]; \
+    } name
+
+#define VECTOR_DECLARE(type, inline_count) \
+    VECTOR_DECLARE_NAMED(vector_##type##_t, type, inline_count)
+
+#define VECTOR_PTR_DECLARE(type, inline_count) \
+    VECTOR_DECLARE_NAMED(vector_##type##_ptr_t, type*, inline_count)
+
+#define VECTOR(type) vector_##type##_t
+
+#define VECTOR_PTR(type) vector_##type##_ptr_t
+
+// Initialization & termination, arguments are evaluated once
+#define VECTOR_INIT(vec, alloc) do { \
+        typeof(vec) vec_ = (vec); \
+        vector_init_((VectorBase*) vec_, vec_->inline_, sizeof(vec_->inline_) / sizeof(vec_->array[0]), (alloc)); \
+    } while (0)
+
+#define VECTOR_FREE(vec) do { \
+        typeof(vec) vec_ = (vec); \
+        vector_free_((VectorBase*) vec_, vec_->inline_, sizeof(vec_->array[0])); \
+    } while (0)
+
+// Capacity
+#define VECTOR_RESERVE(vec, new_capacity) do { \
+        typeof(vec) vec_ = (vec); \
+        vector_reserve_((VectorBase*) vec_, vec_->inline_, sizeof(vec_->array[0]), (new_capacity)); \
+    } while (0)
+
+#define VECTOR_SHRINK_TO_FIT(vec) do { \
+        typeof(vec) vec_ = (vec); \
+        vector_shrink_((VectorBase*) vec_, vec_->inline_, sizeof(vec_->array[0])); \
+    } while (0)
+
+// Functionality
+#define VECTOR_GET(vec, index) \
+    ((vec)->array[index])
+
+#define VECTOR_PUSH(vec, item) do { \
+        typeof(vec) vec_ = (vec); \
+        typeof(vec_->array[0]) item_ = (item); \
+        if (vec_->count == vec_->capacity) { \
+            vector_reserve_((VectorBase*) vec_, vec_->inline_, sizeof(item_), vec_->count + 1); \
+        } \
+        vec_->array[vec_->count++] = item_; \
+    } while (0)
+
+#define VECTOR_APPEND(vec, items, item_count) do { \
+        typeof(vec) vec_ = (vec); \
+        vector_append_((VectorBase*) vec_, vec_->inline_, sizeof(vec_->array[0]), (items), (item_count)); \
+    } while (0)
+
+#define VECTOR_REMOVE(vec, index) do { \
+        typeof(vec) vec_ = (vec); \
+        vector_remove_((VectorBase*) vec_, sizeof(vec_->array[0]), (index)); \
+    } while (0)
+
+#define VECTOR_CLEAR(vec) \
+    ((vec)->count = 0)
+
+// Implementation, use the macros
+void vector_init_(VectorBase* vec, void* storage, uint32_t inline_capacity, const VectorAllocator* allocator);
+
+void vector_free_(VectorBase* vec, void* storage, size_t item_size);
+
+void vector_reserve_(VectorBase* vec, void* storage, size_t item_size, uint32_t capacity);
+
+void vector_shrink_(VectorBase* vec, void* storage, size_t item_size);
+
+void vector_append_(VectorBase* vec, void* storage, size_t item_size, const void* items, uint32_t count);
+
+void vector_remove_(VectorBase* vec, size_t item_size, uint32_t index);
\ No newline at end of file